@@ -0,0 +1,114 @@
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "Fcpp.h"
+#include "Fcpp/batch.h"
+using namespace Fcpp;
+
+// Baseline: CFI_establish called directly
+static void BM_rawEstablish(benchmark::State& state) {
+  std::vector<double> a(state.range(0));
+  for (auto _ : state) {
+    CFI_CDESC_T(1) desc;
+    CFI_index_t extents[1] = {static_cast<CFI_index_t>(a.size())};
+    CFI_establish((CFI_cdesc_t *) &desc, a.data(), CFI_attribute_other,
+        CFI_type_double, sizeof(double), 1, extents);
+    benchmark::DoNotOptimize(&desc);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_rawEstablish)->Arg(64);
+
+// Per-call cost of a fresh descriptor (CFI_establish)
+static void BM_establish(benchmark::State& state) {
+  std::vector<double> a(state.range(0));
+  for (auto _ : state) {
+    cdesc<double> fa(a.data(),a.size());
+    benchmark::DoNotOptimize(fa.get());
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_establish)->Arg(64);
+
+// Per-call cost of a reused descriptor pointed to new storage
+static void BM_rebind(benchmark::State& state) {
+  std::vector<double> a(state.range(0)), b(state.range(0));
+  cdesc<double> fa(a);
+  bool flip = false;
+  for (auto _ : state) {
+    fa.rebind(flip ? a.data() : b.data());
+    flip = !flip;
+    benchmark::DoNotOptimize(fa.get());
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_rebind)->Arg(64);
+
+static void BM_rawEstablish2D(benchmark::State& state) {
+  const int n = state.range(0);
+  std::vector<double> a(n*n);
+  for (auto _ : state) {
+    CFI_CDESC_T(2) desc;
+    CFI_index_t extents[2] = {n, n};
+    CFI_establish((CFI_cdesc_t *) &desc, a.data(), CFI_attribute_other,
+        CFI_type_double, sizeof(double), 2, extents);
+    benchmark::DoNotOptimize(&desc);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_rawEstablish2D)->Arg(16);
+
+static void BM_establish2D(benchmark::State& state) {
+  const int n = state.range(0);
+  std::vector<double> a(n*n);
+  for (auto _ : state) {
+    cdesc<double,2> fa(a.data(),n,n);
+    benchmark::DoNotOptimize(fa.get());
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_establish2D)->Arg(16);
+
+// Reused descriptor pointed to new storage with new extents
+static void BM_rebindReshape2D(benchmark::State& state) {
+  const int n = state.range(0);
+  std::vector<double> a(n*n);
+  cdesc<double,2> fa(a.data(),n,n);
+  int m = n;
+  for (auto _ : state) {
+    m = (m == n) ? n - 1 : n;
+    fa.rebind(a.data(),m,n);
+    benchmark::DoNotOptimize(fa.get());
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_rebindReshape2D)->Arg(16);
+
+// Descriptors for many small arrays: one cdesc per array
+static void BM_establishMany(benchmark::State& state) {
+  std::vector<std::vector<double>> cells(state.range(0), std::vector<double>(8));
+  std::vector<cdesc<double>> descs;
+  descs.reserve(cells.size());
+  for (auto _ : state) {
+    descs.clear();
+    for (auto& c : cells) descs.emplace_back(c);
+    benchmark::DoNotOptimize(descs.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations()*state.range(0));
+}
+BENCHMARK(BM_establishMany)->Arg(1000);
+
+// Same with a reused cdesc_batch
+static void BM_batch(benchmark::State& state) {
+  std::vector<std::vector<double>> cells(state.range(0), std::vector<double>(8));
+  cdesc_batch<double> batch(cells);
+  for (auto _ : state) {
+    batch.assign(cells);
+    benchmark::DoNotOptimize(batch.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations()*state.range(0));
+}
+BENCHMARK(BM_batch)->Arg(1000);
@@ -0,0 +1,187 @@
+#include <numeric>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "Fcpp.h"
+#include "Fcpp/algorithms.h"
+#include "Fcpp/expressions.h"
+using namespace Fcpp;
+
+extern "C" {
+// Fortran routines with an assumed-shape dummy argument
+void fcpp_bench_noop(CFI_cdesc_t *a);
+double fcpp_bench_sum(CFI_cdesc_t *a);
+}
+
+// Array sizes (number of elements) and strides swept below
+static void sizes(benchmark::internal::Benchmark *b) {
+  b->RangeMultiplier(16)->Range(64, 1<<20);
+}
+static void sizes_and_strides(benchmark::internal::Benchmark *b) {
+  b->ArgsProduct({{1<<10, 1<<14, 1<<18}, {1, 2, 4, 16}});
+}
+static void sizes_unit_stride(benchmark::internal::Benchmark *b) {
+  b->ArgsProduct({{1<<10, 1<<14, 1<<18}, {1}});
+}
+
+static void set_counters(benchmark::State& state, std::size_t n) {
+  state.SetItemsProcessed(state.iterations()*n);
+  state.SetBytesProcessed(state.iterations()*n*sizeof(double));
+}
+
+//
+// Iteration over cdesc_ptr
+//
+
+// Baseline: hand-written loop with a constant stride
+static void BM_iterateHandWritten(benchmark::State& state) {
+  const std::size_t n = state.range(0), s = state.range(1);
+  std::vector<double> a(n*s,1.0);
+  const double *p = a.data();
+  for (auto _ : state) {
+    double sum = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      sum += p[i*s];
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  set_counters(state,n);
+}
+BENCHMARK(BM_iterateHandWritten)->Apply(sizes_and_strides);
+
+template<layout layout_>
+static void BM_iterateCdescPtr(benchmark::State& state) {
+  const std::size_t n = state.range(0), s = state.range(1);
+  std::vector<double> a(n*s,1.0);
+  cdesc fa(a);
+  auto sec = fa.section(slice{0,static_cast<CFI_index_t>(n*s),static_cast<CFI_index_t>(s)});
+  for (auto _ : state) {
+    cdesc_ptr<double,1,attr::other,layout_> p(sec.get());
+    double sum = std::accumulate(p.begin(),p.end(),0.0);
+    benchmark::DoNotOptimize(sum);
+  }
+  set_counters(state,n);
+}
+BENCHMARK(BM_iterateCdescPtr<layout::strided>)->Apply(sizes_and_strides);
+BENCHMARK(BM_iterateCdescPtr<layout::contiguous>)->Apply(sizes_unit_stride);
+
+// Same reduction with the SIMD kernel of Fcpp/algorithms.h
+static void BM_sumAlgorithm(benchmark::State& state) {
+  const std::size_t n = state.range(0), s = state.range(1);
+  std::vector<double> a(n*s,1.0);
+  cdesc fa(a);
+  auto sec = fa.section(slice{0,static_cast<CFI_index_t>(n*s),static_cast<CFI_index_t>(s)});
+  for (auto _ : state) {
+    double sum = Fcpp::sum(sec);
+    benchmark::DoNotOptimize(sum);
+  }
+  set_counters(state,n);
+}
+BENCHMARK(BM_sumAlgorithm)->Apply(sizes_and_strides);
+
+//
+// Three-operand update out = a*2 + b
+//
+
+// Baseline: one pass per operation through a temporary
+static void BM_updateTemporaries(benchmark::State& state) {
+  const std::size_t n = state.range(0);
+  std::vector<double> a(n,1.0), b(n,2.0), out(n), tmp(n);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < n; ++i) tmp[i] = a[i]*2.0;
+    for (std::size_t i = 0; i < n; ++i) out[i] = tmp[i] + b[i];
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  set_counters(state,n);
+}
+BENCHMARK(BM_updateTemporaries)->Apply(sizes);
+
+// Fused expression over descriptors
+static void BM_updateExpression(benchmark::State& state) {
+  const std::size_t n = state.range(0);
+  std::vector<double> a(n,1.0), b(n,2.0), out(n);
+  cdesc fa(a), fb(b), fout(out);
+  for (auto _ : state) {
+    fout = fa*2.0 + fb;
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  set_counters(state,n);
+}
+BENCHMARK(BM_updateExpression)->Apply(sizes);
+
+template<layout layout_>
+static void BM_subscriptCdescPtr(benchmark::State& state) {
+  const std::size_t n = state.range(0);
+  std::vector<double> a(n,1.0);
+  cdesc fa(a);
+  for (auto _ : state) {
+    cdesc_ptr<double,1,attr::other,layout_> p(fa.get());
+    double sum = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      sum += p[i];
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  set_counters(state,n);
+}
+BENCHMARK(BM_subscriptCdescPtr<layout::strided>)->Apply(sizes);
+BENCHMARK(BM_subscriptCdescPtr<layout::contiguous>)->Apply(sizes);
+
+//
+// Conversion to std::span
+//
+
+template<layout layout_>
+static void BM_spanConversion(benchmark::State& state) {
+  std::vector<double> a(state.range(0));
+  cdesc fa(a);
+  cdesc_ptr<double,1,attr::other,layout_> p(fa.get());
+  for (auto _ : state) {
+    std::span<double> sp = p;
+    benchmark::DoNotOptimize(sp);
+  }
+}
+BENCHMARK(BM_spanConversion<layout::strided>)->Arg(1024);
+BENCHMARK(BM_spanConversion<layout::contiguous>)->Arg(1024);
+
+//
+// Calls into Fortran
+//
+
+// Round-trip latency of a call with a descriptor argument
+static void BM_fortranRoundTrip(benchmark::State& state) {
+  std::vector<double> a(state.range(0));
+  cdesc fa(a);
+  for (auto _ : state) {
+    fcpp_bench_noop(fa);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_fortranRoundTrip)->Arg(64);
+
+// Construction of the descriptor included in the call
+static void BM_fortranRoundTripFreshDescriptor(benchmark::State& state) {
+  std::vector<double> a(state.range(0));
+  for (auto _ : state) {
+    cdesc fa(a);
+    fcpp_bench_noop(fa);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_fortranRoundTripFreshDescriptor)->Arg(64);
+
+static void BM_fortranSum(benchmark::State& state) {
+  const std::size_t n = state.range(0), s = state.range(1);
+  std::vector<double> a(n*s,1.0);
+  cdesc fa(a);
+  auto sec = fa.section(slice{0,static_cast<CFI_index_t>(n*s),static_cast<CFI_index_t>(s)});
+  for (auto _ : state) {
+    double sum = fcpp_bench_sum(sec);
+    benchmark::DoNotOptimize(sum);
+  }
+  set_counters(state,n);
+}
+BENCHMARK(BM_fortranSum)->Apply(sizes_and_strides);
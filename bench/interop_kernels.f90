@@ -0,0 +1,14 @@
+! void fcpp_bench_noop(CFI_cdesc_t *a);
+subroutine fcpp_bench_noop(a) bind(c)
+use, intrinsic :: iso_c_binding, only: c_double
+implicit none
+real(c_double), intent(inout) :: a(:)
+end subroutine
+
+! double fcpp_bench_sum(CFI_cdesc_t *a);
+real(c_double) function fcpp_bench_sum(a) bind(c)
+use, intrinsic :: iso_c_binding, only: c_double
+implicit none
+real(c_double), intent(in) :: a(:)
+fcpp_bench_sum = sum(a)
+end function
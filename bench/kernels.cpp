@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+
+#include "Fcpp.h"
+using namespace Fcpp;
+
+// Kernels of kernels_bench.f90 written in C++, and the drivers that
+// call their Fortran counterparts through cdesc
+
+namespace {
+
+// Use the contiguous layout when the actual argument allows it, as a
+// kernel tuned for both cases would
+template<int rank_, typename F>
+void with_layout(CFI_cdesc_t *desc, F&& f) {
+    if (CFI_is_contiguous(desc)) {
+        f(cdesc_ptr<double,rank_,attr::other,layout::contiguous>(desc));
+    } else {
+        f(cdesc_ptr<double,rank_>(desc));
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+//
+// Fortran -> C++ (cdesc_ptr)
+//
+
+void cbench_iota(CFI_cdesc_t *x_) {
+    with_layout<1>(x_,[](auto x) { std::iota(x.begin(),x.end(),0.0); });
+}
+
+double cbench_dot(CFI_cdesc_t *x_, CFI_cdesc_t *y_) {
+    double r = 0;
+    with_layout<1>(x_,[&](auto x) {
+        with_layout<1>(y_,[&](auto y) {
+            r = std::transform_reduce(x.begin(),x.end(),y.begin(),0.0);
+        });
+    });
+    return r;
+}
+
+void cbench_axpy(double a, CFI_cdesc_t *x_, CFI_cdesc_t *y_) {
+    with_layout<1>(x_,[&](auto x) {
+        with_layout<1>(y_,[&](auto y) {
+            const std::size_t n = x.size();
+            for (std::size_t i = 0; i < n; ++i) y[i] += a*x[i];
+        });
+    });
+}
+
+void cbench_stencil(CFI_cdesc_t *a_, CFI_cdesc_t *b_) {
+    with_layout<2>(a_,[&](auto a) {
+        with_layout<2>(b_,[&](auto b) {
+            const std::size_t m = a.extent(0), n = a.extent(1);
+            for (std::size_t j = 1; j + 1 < n; ++j)
+                for (std::size_t i = 1; i + 1 < m; ++i)
+                    b(i,j) = 0.25*(a(i-1,j) + a(i+1,j) + a(i,j-1) + a(i,j+1));
+        });
+    });
+}
+
+void cbench_fill(CFI_cdesc_t *x_, double v) {
+    with_layout<1>(x_,[=](auto x) { std::fill(x.begin(),x.end(),v); });
+}
+
+//
+// C++ -> Fortran (cdesc)
+//
+
+void fbench_iota(CFI_cdesc_t *x);
+double fbench_dot(CFI_cdesc_t *x, CFI_cdesc_t *y);
+void fbench_axpy(double a, CFI_cdesc_t *x, CFI_cdesc_t *y);
+void fbench_stencil(CFI_cdesc_t *a, CFI_cdesc_t *b);
+void fbench_fill(CFI_cdesc_t *x, double v);
+
+// Call kernel reps times on x(1::stride) and y(1::stride), or on
+// a(1::stride,:) and b(1::stride,:) of extents m*stride x n for the
+// stencil; x and y point to the whole storage. The descriptors are set
+// up for every call, as a C++ caller usually would.
+double cbench_drive(int kernel, double *x, double *y, std::int64_t m, std::int64_t n,
+                    int stride, int reps) {
+    const CFI_index_t len = m*stride;
+    const slice s{0,len,stride};
+    double sink = 0;
+    for (int r = 0; r < reps; ++r) {
+        switch (kernel) {
+        case 1: {
+            cdesc<double> fx(x,len);
+            fbench_iota(fx.section(s));
+            break;
+        }
+        case 2: {
+            cdesc<double> fx(x,len), fy(y,len);
+            sink += fbench_dot(fx.section(s),fy.section(s));
+            break;
+        }
+        case 3: {
+            cdesc<double> fx(x,len), fy(y,len);
+            fbench_axpy(0.5,fx.section(s),fy.section(s));
+            break;
+        }
+        case 4: {
+            cdesc<double,2> fa(x,len,n), fb(y,len,n);
+            fbench_stencil(fa.section(s,full_extent),fb.section(s,full_extent));
+            break;
+        }
+        case 5: {
+            cdesc<double> fx(x,len);
+            fbench_fill(fx.section(s),1.5);
+            break;
+        }
+        }
+    }
+    return sink;
+}
+
+} // extern "C"
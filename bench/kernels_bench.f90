@@ -0,0 +1,242 @@
+! End-to-end timings of simple kernels, each written as native Fortran,
+! as C++ called from Fortran through cdesc_ptr (kernels.cpp), and as 
+! Fortran called from C++ through cdesc, on contiguous and (1::2) actuals
+!
+!   kernels_bench [elements per measurement]
+!
+! GB/s counts the bytes of the elements accessed, not the whole storage.
+
+module bench_kernels
+use, intrinsic :: iso_c_binding, only: c_double
+implicit none
+
+contains
+
+subroutine iota_f(x)
+real(c_double), intent(out) :: x(:)
+integer :: i
+do i = 1, size(x)
+    x(i) = i - 1
+end do
+end subroutine
+
+real(c_double) function dot_f(x,y)
+real(c_double), intent(in) :: x(:), y(:)
+dot_f = dot_product(x,y)
+end function
+
+subroutine axpy_f(a,x,y)
+real(c_double), intent(in) :: a, x(:)
+real(c_double), intent(inout) :: y(:)
+y = y + a*x
+end subroutine
+
+subroutine stencil_f(a,b)
+real(c_double), intent(in) :: a(:,:)
+real(c_double), intent(inout) :: b(:,:)
+integer :: m, n
+m = size(a,1)
+n = size(a,2)
+b(2:m-1,2:n-1) = 0.25_c_double*(a(1:m-2,2:n-1) + a(3:m,2:n-1) + &
+                                a(2:m-1,1:n-2) + a(2:m-1,3:n))
+end subroutine
+
+subroutine fill_f(x,v)
+real(c_double), intent(out) :: x(:)
+real(c_double), intent(in) :: v
+x = v
+end subroutine
+
+! Entry points called from C++ (cbench_drive)
+
+subroutine fbench_iota(x) bind(c)
+real(c_double), intent(out) :: x(:)
+call iota_f(x)
+end subroutine
+
+real(c_double) function fbench_dot(x,y) bind(c)
+real(c_double), intent(in) :: x(:), y(:)
+fbench_dot = dot_f(x,y)
+end function
+
+subroutine fbench_axpy(a,x,y) bind(c)
+real(c_double), value :: a
+real(c_double), intent(in) :: x(:)
+real(c_double), intent(inout) :: y(:)
+call axpy_f(a,x,y)
+end subroutine
+
+subroutine fbench_stencil(a,b) bind(c)
+real(c_double), intent(in) :: a(:,:)
+real(c_double), intent(inout) :: b(:,:)
+call stencil_f(a,b)
+end subroutine
+
+subroutine fbench_fill(x,v) bind(c)
+real(c_double), intent(out) :: x(:)
+real(c_double), value :: v
+call fill_f(x,v)
+end subroutine
+
+end module
+
+program kernels_bench
+use, intrinsic :: iso_c_binding, only: c_double, c_int, c_int64_t
+use, intrinsic :: iso_fortran_env, only: int64
+use bench_kernels
+implicit none
+
+interface
+    subroutine cbench_iota(x) bind(c)
+        import c_double
+        real(c_double), intent(out) :: x(:)
+    end subroutine
+    real(c_double) function cbench_dot(x,y) bind(c)
+        import c_double
+        real(c_double), intent(in) :: x(:), y(:)
+    end function
+    subroutine cbench_axpy(a,x,y) bind(c)
+        import c_double
+        real(c_double), value :: a
+        real(c_double), intent(in) :: x(:)
+        real(c_double), intent(inout) :: y(:)
+    end subroutine
+    subroutine cbench_stencil(a,b) bind(c)
+        import c_double
+        real(c_double), intent(in) :: a(:,:)
+        real(c_double), intent(inout) :: b(:,:)
+    end subroutine
+    subroutine cbench_fill(x,v) bind(c)
+        import c_double
+        real(c_double), intent(out) :: x(:)
+        real(c_double), value :: v
+    end subroutine
+    ! Repeats a kernel from C++ on the whole storage of x and y
+    real(c_double) function cbench_drive(kernel,x,y,m,n,stride,reps) bind(c)
+        import c_double, c_int, c_int64_t
+        integer(c_int), value :: kernel, stride, reps
+        real(c_double) :: x(*), y(*)
+        integer(c_int64_t), value :: m, n
+    end function
+end interface
+
+character(len=7), parameter :: kernels(5) = &
+    [character(len=7) :: 'iota', 'dot', 'axpy', 'stencil', 'fill']
+character(len=6), parameter :: variants(3) = &
+    [character(len=6) :: 'native', 'f->c++', 'c++->f']
+! Bytes accessed per element
+integer, parameter :: bytes(5) = [8, 16, 24, 16, 8]
+integer, parameter :: sizes(3) = [2**10, 2**14, 2**20]
+integer, parameter :: strides(2) = [1, 2]
+
+real(c_double), allocatable :: x(:), y(:), a(:,:), b(:,:)
+real(c_double) :: sink = 0
+integer(int64) :: work = 2_int64**26
+character(len=32) :: arg
+integer :: k, v, s, i
+
+if (command_argument_count() > 0) then
+    call get_command_argument(1,arg)
+    read(arg,*) work
+end if
+
+write(*,'(a8,a8,a8,a10,a12,a10)') 'kernel', 'variant', 'stride', 'elements', 'ns/element', 'GB/s'
+do k = 1, size(kernels)
+    do s = 1, size(strides)
+        do i = 1, size(sizes)
+            do v = 1, size(variants)
+                call measure(k,v,strides(s),sizes(i))
+            end do
+        end do
+    end do
+end do
+write(*,'(a,es12.4)') 'checksum', sink
+
+contains
+
+subroutine measure(k,v,stride,n)
+integer, intent(in) :: k, v, stride, n
+integer(int64) :: t0, t1, rate, elems
+integer :: m, reps
+real(c_double) :: secs
+
+if (kernels(k) == 'stencil') then
+    m = nint(sqrt(real(n)))
+    allocate(a(m*stride,m), b(m*stride,m))
+    a = 1
+    b = 0
+    elems = int(m,int64)**2
+else
+    m = n
+    allocate(x(n*stride), y(n*stride))
+    x = 1
+    y = 1
+    elems = n
+end if
+reps = int(max(1_int64, work/elems))
+
+call run(k,v,stride,m,1)
+call system_clock(t0,rate)
+call run(k,v,stride,m,reps)
+call system_clock(t1)
+secs = real(t1 - t0,c_double)/real(rate,c_double)
+
+write(*,'(a8,a8,i8,i10,f12.3,f10.2)') kernels(k), variants(v), stride, elems, &
+    1e9_c_double*secs/(real(elems,c_double)*reps), &
+    real(bytes(k),c_double)*real(elems,c_double)*reps/secs/1e9_c_double
+
+if (allocated(x)) deallocate(x, y)
+if (allocated(a)) deallocate(a, b)
+end subroutine
+
+! Run kernel k reps times as variant v on extents m (m x m for the stencil)
+subroutine run(k,v,stride,m,reps)
+integer, intent(in) :: k, v, stride, m, reps
+integer :: r
+
+if (v == 3) then
+    if (kernels(k) == 'stencil') then
+        sink = sink + cbench_drive(k,a,b,int(m,c_int64_t),int(m,c_int64_t),stride,reps)
+    else
+        sink = sink + cbench_drive(k,x,y,int(m,c_int64_t),1_c_int64_t,stride,reps)
+    end if
+    return
+end if
+
+do r = 1, reps
+    select case (k)
+    case (1)
+        if (v == 1) then
+            call iota_f(x(1::stride))
+        else
+            call cbench_iota(x(1::stride))
+        end if
+    case (2)
+        if (v == 1) then
+            sink = sink + dot_f(x(1::stride),y(1::stride))
+        else
+            sink = sink + cbench_dot(x(1::stride),y(1::stride))
+        end if
+    case (3)
+        if (v == 1) then
+            call axpy_f(0.5_c_double,x(1::stride),y(1::stride))
+        else
+            call cbench_axpy(0.5_c_double,x(1::stride),y(1::stride))
+        end if
+    case (4)
+        if (v == 1) then
+            call stencil_f(a(1::stride,:),b(1::stride,:))
+        else
+            call cbench_stencil(a(1::stride,:),b(1::stride,:))
+        end if
+    case (5)
+        if (v == 1) then
+            call fill_f(x(1::stride),1.5_c_double)
+        else
+            call cbench_fill(x(1::stride),1.5_c_double)
+        end if
+    end select
+end do
+end subroutine
+
+end program
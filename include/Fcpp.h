@@ -6,13 +6,39 @@
 
 #include <type_traits>
 #include <iterator>
+#include <compare>
 #include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <new>
+#include <memory>
+#include <ranges>
+
+#include <version>
 
 #if __cpp_lib_span
 #include <span> // C++ 20
 #endif
 
+// std::mdspan from the standard library (C++ 23), or from a reference
+// implementation placing it in namespace std, included through
+// FCPP_MDSPAN_HEADER (e.g. <mdspan/mdspan.hpp> of kokkos/mdspan)
+#if defined(FCPP_MDSPAN_HEADER)
+#include FCPP_MDSPAN_HEADER
+#define FCPP_HAS_MDSPAN 1
+#elif __cpp_lib_mdspan
+#include <mdspan> // C++ 23
+#define FCPP_HAS_MDSPAN 1
+#else
+#define FCPP_HAS_MDSPAN 0
+#endif
+
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <cstdlib>
 
 #include <cassert>
 
@@ -20,51 +46,506 @@
 // for a peak into the internals of a particular vendor:
 // https://github.com/gcc-mirror/gcc/blob/master/libgfortran/ISO_Fortran_binding.h
 
+/**
+ * Validation of descriptors, arguments and indices, selected by defining
+ * FCPP_VALIDATION before including the header:
+ *
+ *   FCPP_VALIDATION_UNCHECKED  no checks, the conditions are not evaluated
+ *   FCPP_VALIDATION_ASSERT     assert, disabled by NDEBUG (default)
+ *   FCPP_VALIDATION_THROW      throw Fcpp::validation_error
+ *   FCPP_VALIDATION_CALLBACK   call the handler installed with 
+ *                              Fcpp::set_validation_handler
+ *
+ * Bounds checks in the subscript operators are controlled separately by
+ * FCPP_BOUNDS_CHECK (0 or 1), which is on by default in checked builds
+ * without NDEBUG.
+ */
+#define FCPP_VALIDATION_UNCHECKED 0
+#define FCPP_VALIDATION_ASSERT 1
+#define FCPP_VALIDATION_THROW 2
+#define FCPP_VALIDATION_CALLBACK 3
+
+#ifndef FCPP_VALIDATION
+#define FCPP_VALIDATION FCPP_VALIDATION_ASSERT
+#endif
+
+#ifndef FCPP_BOUNDS_CHECK
+#if FCPP_VALIDATION != FCPP_VALIDATION_UNCHECKED && !defined(NDEBUG)
+#define FCPP_BOUNDS_CHECK 1
+#else
+#define FCPP_BOUNDS_CHECK 0
+#endif
+#endif
+
 namespace Fcpp {
 
+// Error raised by failed checks with FCPP_VALIDATION_THROW
+class validation_error : public std::logic_error {
+public:
+    using std::logic_error::logic_error;
+};
+
+// Handler of failed checks with FCPP_VALIDATION_CALLBACK; 
+// if it returns, execution continues past the failed check, and the
+// code that follows is not guaranteed to be safe (e.g. to stay in bounds)
+using validation_handler = void (*)(const char *condition, const char *file, int line);
+
 namespace Fcpp_impl_ {
 
+[[noreturn]] inline void default_validation_handler(
+    const char *condition, const char *file, int line) {
+    std::cerr << file << ":" << line << ": Fcpp check failed: " << condition << std::endl;
+    std::abort();
+}
+
+inline validation_handler validation_handler_ = default_validation_handler;
+
+[[noreturn]] inline void throw_validation_error(
+    const char *condition, const char *file, int line) {
+    throw Fcpp::validation_error(std::string(file) + ":" + std::to_string(line) + 
+        ": Fcpp check failed: " + condition);
+}
+
+} // namespace Fcpp_impl_
+
+// Install a handler, returning the previous one
+inline validation_handler set_validation_handler(validation_handler h) {
+    validation_handler prev = Fcpp_impl_::validation_handler_;
+    Fcpp_impl_::validation_handler_ = h ? h : Fcpp_impl_::default_validation_handler;
+    return prev;
+}
+
+} // namespace Fcpp
+
+#if FCPP_VALIDATION == FCPP_VALIDATION_UNCHECKED
+#define FCPP_CHECK(cond) ((void) 0)
+#elif FCPP_VALIDATION == FCPP_VALIDATION_ASSERT
+#define FCPP_CHECK(cond) assert(cond)
+#elif FCPP_VALIDATION == FCPP_VALIDATION_THROW
+#define FCPP_CHECK(cond) ((cond) ? (void) 0 : \
+    Fcpp::Fcpp_impl_::throw_validation_error(#cond, __FILE__, __LINE__))
+#elif FCPP_VALIDATION == FCPP_VALIDATION_CALLBACK
+#define FCPP_CHECK(cond) ((cond) ? (void) 0 : \
+    Fcpp::Fcpp_impl_::validation_handler_(#cond, __FILE__, __LINE__))
+#else
+#error "Unknown value of FCPP_VALIDATION"
+#endif
+
+#if FCPP_BOUNDS_CHECK
+#define FCPP_CHECK_BOUNDS(cond) FCPP_CHECK(cond)
+#else
+#define FCPP_CHECK_BOUNDS(cond) ((void) 0)
+#endif
+
+/**
+ * Instrumentation of the hot paths, compiled in with FCPP_INSTRUMENT=1:
+ * counts of descriptor constructions, sections, contiguity checks and 
+ * strided iterations, with the bytes they describe, passed on to an 
+ * optional callback (see Fcpp/instrument.h for the summary and the 
+ * timing of Fortran calls)
+ */
+#ifndef FCPP_INSTRUMENT
+#define FCPP_INSTRUMENT 0
+#endif
+
+#if FCPP_INSTRUMENT
+
+#include <atomic>
+
+namespace Fcpp {
+
+enum class event_kind {
+    establish,          // descriptor constructed (CFI_establish)
+    section,            // section or part (CFI_section, CFI_select_part)
+    contiguity_check,   // CFI_is_contiguous
+    strided_iteration,  // iteration over a non-contiguous array
+    call_begin,         // instrumented Fortran call
+    call_end
+};
+
+struct instrumentation_event {
+    event_kind kind;
+    const char *name;           // name of the call, or nullptr
+    std::size_t bytes;          // size of the array(s) described
+    std::uint64_t nanoseconds;  // duration (call_end only)
+};
+
+using instrumentation_callback = void (*)(const instrumentation_event&);
+
+namespace Fcpp_impl_ {
+
+struct event_counters {
+    std::atomic<std::uint64_t> count[6];
+    std::atomic<std::uint64_t> bytes[6];
+};
+
+inline event_counters counters_{};
+inline std::atomic<instrumentation_callback> callback_{nullptr};
+
+inline void record(event_kind kind, std::size_t bytes, 
+                   const char *name = nullptr, std::uint64_t ns = 0) {
+    const auto k = static_cast<int>(kind);
+    counters_.count[k].fetch_add(1, std::memory_order_relaxed);
+    counters_.bytes[k].fetch_add(bytes, std::memory_order_relaxed);
+    if (auto cb = callback_.load(std::memory_order_relaxed)) {
+        cb(instrumentation_event{kind, name, bytes, ns});
+    }
+}
+
+inline std::size_t described_bytes(const CFI_cdesc_t *desc) {
+    if (!desc->base_addr) return 0;
+    std::size_t n = desc->elem_len;
+    for (int d = 0; d < desc->rank; ++d) n *= static_cast<std::size_t>(desc->dim[d].extent);
+    return n;
+}
+
+} // namespace Fcpp_impl_
+
+} // namespace Fcpp
+
+#define FCPP_RECORD(kind, desc) \
+    Fcpp::Fcpp_impl_::record(Fcpp::event_kind::kind, Fcpp::Fcpp_impl_::described_bytes(desc))
+#else
+#define FCPP_RECORD(kind, desc) ((void) 0)
+#endif
+
+// Qualifier promising that a pointer is the only way its elements are 
+// accessed in a scope, used by the kernels taking Fcpp::no_alias
+#if defined(__GNUC__) || defined(__clang__)
+#define FCPP_RESTRICT __restrict__
+#elif defined(_MSC_VER)
+#define FCPP_RESTRICT __restrict
+#else
+#define FCPP_RESTRICT
+#endif
+
+namespace Fcpp {
+
+/**
+ * Trait marking a C++ struct as interoperable with a BIND(C) derived 
+ * type, so that it maps to CFI_type_struct; specialize it with the 
+ * FCPP_INTEROPERABLE_STRUCT macro below
+ */
+template<typename T>
+struct interoperable_struct : std::false_type {};
+
+namespace Fcpp_impl_ {
+
+// Integer type codes; Fortran has no unsigned integers, so unsigned
+// types share the code of the signed type of the same size
+template<typename T>
+constexpr CFI_type_t integer_type() {
+    using S = std::make_signed_t<T>;
+    if constexpr (std::is_same_v<S,signed char>) return CFI_type_signed_char;
+    else if constexpr (std::is_same_v<S,short>) return CFI_type_short;
+    else if constexpr (std::is_same_v<S,int>) return CFI_type_int;
+    else if constexpr (std::is_same_v<S,long>) return CFI_type_long;
+    else if constexpr (std::is_same_v<S,long long>) return CFI_type_long_long;
+    else return CFI_type_other;
+}
+
+// C++ counterpart of the C type _Bool, in terms of which CFI_type_Bool
+// is defined where the type codes encode the kind; the code is built
+// here instead, as _Bool is not a C++ type
+using c_bool = bool;
+
+#if defined(CFI_type_Logical) && defined(CFI_type_kind_shift)
+inline constexpr CFI_type_t bool_type = 
+    CFI_type_Logical + (sizeof(c_bool) << CFI_type_kind_shift);
+#else
+inline constexpr CFI_type_t bool_type = CFI_type_Bool;
+#endif
+
 /**
- * Function templates to convert a template argument 
+ * Function template to convert a template argument 
  * into an integer type code
+ *
+ * Only the fundamental types are listed, so typedefs such as int32_t, 
+ * int_fast16_t or ptrdiff_t resolve to the code of the type they alias 
+ * on the platform (the codes of ISO_Fortran_binding.h agree with this).
+ * Other types map to CFI_type_other.
  */ 
 template<typename T>
-constexpr CFI_type_t type();
+constexpr CFI_type_t type() {
+    using U = std::remove_cv_t<T>;
+    if constexpr (std::is_same_v<U,bool>) return bool_type;
+    else if constexpr (std::is_same_v<U,char>) return CFI_type_char;
+    else if constexpr (std::is_same_v<U,char32_t>) return CFI_type_ucs4_char;
+    else if constexpr (std::is_same_v<U,std::size_t>) return CFI_type_size_t;
+    else if constexpr (std::is_same_v<U,wchar_t> || std::is_same_v<U,char8_t> || 
+                       std::is_same_v<U,char16_t>) return CFI_type_other;
+    else if constexpr (std::is_integral_v<U>) return integer_type<U>();
+    else if constexpr (std::is_same_v<U,float>) return CFI_type_float;
+    else if constexpr (std::is_same_v<U,double>) return CFI_type_double;
+    else if constexpr (std::is_same_v<U,long double>) return CFI_type_long_double;
+    else if constexpr (std::is_same_v<U,std::complex<float>>) return CFI_type_float_Complex;
+    else if constexpr (std::is_same_v<U,std::complex<double>>) return CFI_type_double_Complex;
+    else if constexpr (std::is_same_v<U,std::complex<long double>>) return CFI_type_long_double_Complex;
+    else if constexpr (std::is_pointer_v<U> && 
+                       std::is_function_v<std::remove_pointer_t<U>>) return CFI_type_cfunptr;
+    else if constexpr (std::is_pointer_v<U>) return CFI_type_cptr;
+    else if constexpr (Fcpp::interoperable_struct<U>::value) return CFI_type_struct;
+    else return CFI_type_other;
+}
+
+// Codes other than CFI_type_other are negative when the Fortran 
+// compiler has no matching kind (e.g. long double on some targets)
+template<typename T>
+inline constexpr bool is_supported_type = 
+    (type<T>() == CFI_type_other || type<T>() >= 0);
+
+// Check the type of a descriptor received from Fortran against T;
+// derived types may come as either CFI_type_struct or CFI_type_other
+template<typename T>
+constexpr bool type_matches(const CFI_cdesc_t *desc) {
+    constexpr CFI_type_t t = type<T>();
+    if constexpr (t == CFI_type_char || t == CFI_type_ucs4_char) {
+        // The length of character variables is free
+        return desc->type == t;
+    } else if constexpr (t == CFI_type_other || t == CFI_type_struct) {
+        return (desc->type == CFI_type_struct || desc->type == CFI_type_other) &&
+            desc->elem_len == sizeof(T);
+    } else {
+        return desc->type == t && desc->elem_len == sizeof(T);
+    }
+}
+
+} // namespace Fcpp_impl_
+
+} // namespace Fcpp
+
+/**
+ * Register S as interoperable with a BIND(C) derived type, checking 
+ * its layout and its size (c_sizeof on the Fortran side) and alignment
+ *
+ *   FCPP_INTEROPERABLE_STRUCT(particle, 24, 8);
+ *
+ * Must be used at global scope.
+ */
+#define FCPP_INTEROPERABLE_STRUCT(S, elem_len, alignment)                \
+    template<> struct Fcpp::interoperable_struct<S> : std::true_type {   \
+        static_assert(std::is_standard_layout_v<S> &&                    \
+                      std::is_trivially_copyable_v<S>,                   \
+            "Interoperable structs must be trivially copyable and have " \
+            "standard layout");                                          \
+        static_assert(sizeof(S) == (elem_len),                           \
+            "Size does not match the Fortran derived type");             \
+        static_assert(alignof(S) == (alignment),                         \
+            "Alignment does not match the Fortran derived type");        \
+    }
+
+namespace Fcpp {
+
+namespace Fcpp_impl_ {
 
-// Non-interoperable structure (default)
+/**
+ * Random-access iterator over the elements of a rank-1 array
+ * with a constant (possibly negative) stride measured in elements.
+ * Instantiated with a const-qualified T it acts as a constant iterator.
+ */
 template<typename T>
-constexpr CFI_type_t type(){ return CFI_type_other; } 
-
-// Specializations for supported types
-template<>
-constexpr CFI_type_t type<char>(){ return CFI_type_char; }
-template<>
-constexpr CFI_type_t type<float>(){ return CFI_type_float; } 
-template<>
-constexpr CFI_type_t type<double>(){ return CFI_type_double; } 
-template<>
-constexpr CFI_type_t type<std::complex<float>>(){ return CFI_type_float_Complex; } 
-template<>
-constexpr CFI_type_t type<std::complex<double>>(){ return CFI_type_double_Complex; }
-template<>
-constexpr CFI_type_t type<int>(){ return CFI_type_int; } 
-template<>
-constexpr CFI_type_t type<long>(){ return CFI_type_long; } 
-template<>
-constexpr CFI_type_t type<long long>(){ return CFI_type_long_long; } 
-template<>
-constexpr CFI_type_t type<std::size_t>(){ return CFI_type_size_t; }
-template<>
-constexpr CFI_type_t type<int8_t>(){ return CFI_type_int8_t; }
-template<>
-constexpr CFI_type_t type<int16_t>(){ return CFI_type_int16_t; }
-//template<>
-//constexpr CFI_type_t type<std::int32_t>(){ return CFI_type_int32_t; }
-//template<>
-//constexpr CFI_type_t type<std::int64_t>(){ return CFI_type_int64_t; }
-template<>
-constexpr CFI_type_t type<void*>(){ return CFI_type_cptr; }
+class strided_iterator {
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using iterator_concept  = std::random_access_iterator_tag;
+    using difference_type   = std::ptrdiff_t;
+    using value_type        = std::remove_cv_t<T>;
+    using pointer           = T*;
+    using reference         = T&;
+
+    constexpr strided_iterator() = default;
+    constexpr strided_iterator(pointer ptr, difference_type stride) 
+        : ptr_(ptr), stride_(stride) {}
+
+    // Conversion from a mutable to a constant iterator
+    template<typename U>
+        requires (!std::is_same_v<U,T> && std::is_convertible_v<U*,T*>)
+    constexpr strided_iterator(const strided_iterator<U>& other)
+        : ptr_(other.base()), stride_(other.stride()) {}
+
+    constexpr pointer base() const { return ptr_; }
+    constexpr difference_type stride() const { return stride_; }
+
+    constexpr reference operator*() const { return *ptr_; }
+    constexpr pointer operator->() const { return ptr_; }
+    constexpr reference operator[](difference_type n) const { 
+        return ptr_[n*stride_]; 
+    }
+
+    constexpr strided_iterator& operator++() { ptr_ += stride_; return *this; }
+    constexpr strided_iterator& operator--() { ptr_ -= stride_; return *this; }
+    constexpr strided_iterator operator++(int) { 
+        strided_iterator tmp = *this;
+        ++(*this);
+        return tmp;
+    }
+    constexpr strided_iterator operator--(int) { 
+        strided_iterator tmp = *this;
+        --(*this);
+        return tmp;
+    }
+
+    constexpr strided_iterator& operator+=(difference_type n) { 
+        ptr_ += n*stride_; 
+        return *this; 
+    }
+    constexpr strided_iterator& operator-=(difference_type n) { 
+        ptr_ -= n*stride_; 
+        return *this; 
+    }
+
+    friend constexpr strided_iterator operator+(strided_iterator it, difference_type n) {
+        return it += n;
+    }
+    friend constexpr strided_iterator operator+(difference_type n, strided_iterator it) {
+        return it += n;
+    }
+    friend constexpr strided_iterator operator-(strided_iterator it, difference_type n) {
+        return it -= n;
+    }
+    friend constexpr difference_type operator-(const strided_iterator& lhs, 
+                                               const strided_iterator& rhs) {
+        // A zero stride only occurs for iterators over empty arrays
+        return lhs.stride_ == 0 ? 0 : (lhs.ptr_ - rhs.ptr_) / lhs.stride_;
+    }
+
+    friend constexpr bool operator==(const strided_iterator& lhs, 
+                                     const strided_iterator& rhs) {
+        return lhs.ptr_ == rhs.ptr_;
+    }
+    // Ordering follows the position in the sequence, which is the 
+    // reverse of the address order when the stride is negative
+    friend constexpr std::strong_ordering operator<=>(const strided_iterator& lhs, 
+                                                      const strided_iterator& rhs) {
+        return (lhs - rhs) <=> 0;
+    }
+
+private:
+    pointer ptr_{nullptr};
+    difference_type stride_{1};
+};
+
+/**
+ * Offset (in elements) of the element with zero-based indices idx...
+ * given the element strides sm. When unit_first is true, the stride of
+ * the first dimension is known to be one at compile time.
+ */
+template<bool unit_first, std::size_t N, typename... Idx>
+constexpr std::ptrdiff_t linear_offset(
+    const std::array<std::ptrdiff_t,N>& sm, Idx... idx) {
+    static_assert(sizeof...(Idx) == N, 
+        "Number of indices must be equal to the rank");
+    static_assert((std::is_integral_v<Idx> && ...), 
+        "Indices must be of integral type");
+    return [&]<std::size_t... d>(std::index_sequence<d...>) {
+        return (std::ptrdiff_t{0} + ... + 
+            ((unit_first && d == 0) ? static_cast<std::ptrdiff_t>(idx) 
+                                    : static_cast<std::ptrdiff_t>(idx)*sm[d]));
+    }(std::index_sequence_for<Idx...>{});
+}
+
+// CFI_establish ignores the extents when the base address is null, and
+// a null address denotes an unallocated array, so empty arrays point
+// to this placeholder instead (never dereferenced)
+inline void* empty_base_addr() {
+    alignas(std::max_align_t) static std::byte empty[sizeof(std::max_align_t)];
+    return empty;
+}
+
+// Bytes taken by the elements of an array with the given extents, as
+// read from a file or a message; false if an extent is negative or the
+// size does not fit in std::size_t
+inline bool storage_bytes(const CFI_index_t *extents, int rank, 
+                          std::size_t elem_len, std::size_t& bytes) {
+    constexpr std::size_t max = std::numeric_limits<std::size_t>::max();
+    std::size_t n = elem_len;
+    for (int d = 0; d < rank; ++d) {
+        if (extents[d] < 0) return false;
+        const std::size_t e = static_cast<std::size_t>(extents[d]);
+        if (e != 0 && n > max / e) return false;
+        n *= e;
+    }
+    bytes = n;
+    return true;
+}
+
+// True if the zero-based indices idx... are within the extents of desc
+template<typename... Idx>
+constexpr bool in_bounds(const CFI_cdesc_t *desc, Idx... idx) {
+    int d = 0;
+    return ((static_cast<CFI_index_t>(idx) >= 0 && 
+             static_cast<CFI_index_t>(idx) < desc->dim[d++].extent) && ...);
+}
+
+/**
+ * Allocate an allocatable or pointer array of the given extents
+ * (with lower bounds equal to one, as in Fortran)
+ */
+template<int rank_>
+void allocate(CFI_cdesc_t *desc, const CFI_index_t extents[]) {
+    CFI_index_t lower[rank_ > 0 ? rank_ : 1], upper[rank_ > 0 ? rank_ : 1];
+    for (int d = 0; d < rank_; ++d) {
+        lower[d] = 1;
+        upper[d] = extents[d];
+    }
+    int status = CFI_allocate(desc, lower, upper, desc->elem_len);
+    if (status == CFI_ERROR_MEM_ALLOCATION) {
+        throw std::bad_alloc();
+    }
+    FCPP_CHECK(status == CFI_SUCCESS);
+}
+
+// Deallocate an allocatable or pointer array, if allocated
+inline void deallocate(CFI_cdesc_t *desc) {
+    if (desc->base_addr) {
+        [[maybe_unused]] int status = CFI_deallocate(desc);
+        FCPP_CHECK(status == CFI_SUCCESS);
+    }
+}
+
+// Reallocate an array, unless it already has the requested extents.
+// The array contents are not preserved.
+template<int rank_>
+void reallocate(CFI_cdesc_t *desc, const CFI_index_t extents[]) {
+    if (desc->base_addr) {
+        bool same = true;
+        for (int d = 0; d < rank_; ++d) {
+            same = same && (desc->dim[d].extent == extents[d]);
+        }
+        if (same) return;
+        deallocate(desc);
+    }
+    allocate<rank_>(desc,extents);
+}
+
+/**
+ * Establish an array whose leading dimension is stored with ld elements
+ * (ld >= extents[0]), as a section of the parent array (ld, extents[1], ...)
+ */
+template<int rank_>
+int establish_padded(CFI_cdesc_t *desc, void *ptr, CFI_attribute_t attribute,
+    CFI_type_t type, std::size_t elem_len, CFI_index_t ld, const CFI_index_t extents[]) {
+    static_assert(rank_ > 0, "Rank must be positive to pad the leading dimension");
+    FCPP_CHECK(ld >= extents[0]);
+
+    CFI_CDESC_T(rank_) parent;
+    CFI_index_t parent_extents[rank_], lower[rank_], upper[rank_], strides[rank_];
+    for (int d = 0; d < rank_; ++d) {
+        parent_extents[d] = (d == 0) ? ld : extents[d];
+        lower[d] = 0;
+        upper[d] = extents[d] - 1;
+        strides[d] = 1; // libgfortran does not accept null strides
+    }
+
+    int status = CFI_establish((CFI_cdesc_t *) &parent, ptr, CFI_attribute_other,
+        type, elem_len, rank_, parent_extents);
+    if (status != CFI_SUCCESS) return status;
+
+    status = CFI_establish(desc, ptr, attribute, type, elem_len, rank_, extents);
+    if (status != CFI_SUCCESS) return status;
 
+    return CFI_section(desc, (CFI_cdesc_t *) &parent, lower, upper, strides);
+}
 
 } // namespace Fcpp_internal
 
@@ -77,6 +558,306 @@ enum class attr : CFI_attribute_t {
     pointer     = CFI_attribute_pointer
 };
 
+/**
+ *  Number of elements used to store the leading dimension of an array
+ */
+struct leading_dim {
+    CFI_index_t value;
+};
+
+/**
+ *  Tag promising that the output of an operation does not overlap its
+ *  inputs, e.g. assign(out, a + b, no_alias), so that the elements can
+ *  be accessed through restrict-qualified pointers
+ */
+struct no_alias_t { explicit no_alias_t() = default; };
+inline constexpr no_alias_t no_alias{};
+
+/**
+ *  Section specifiers, used like the subscript triplets of a Fortran 
+ *  array section, but with zero-based indices:
+ *   - an integer index selects a single element and removes the dimension,
+ *   - full_extent selects the whole dimension (the Fortran :),
+ *   - slice{first,last,step} selects the half-open range [first,last)
+ *     with the given (possibly negative) step.
+ */
+struct full_extent_t { explicit full_extent_t() = default; };
+inline constexpr full_extent_t full_extent{};
+
+struct slice {
+    CFI_index_t first;
+    CFI_index_t last;
+    CFI_index_t step = 1;
+};
+
+namespace Fcpp_impl_ {
+
+// Bounds of a section specifier relative to a dimension with lower
+// bound lb and extent ext, in the form expected by CFI_section
+inline void section_bounds(CFI_index_t lb, CFI_index_t ext, full_extent_t,
+    CFI_index_t& lower, CFI_index_t& upper, CFI_index_t& stride) {
+    lower = lb;
+    upper = lb + ext - 1;
+    stride = 1;
+}
+
+inline void section_bounds(CFI_index_t lb, [[maybe_unused]] CFI_index_t ext, slice s,
+    CFI_index_t& lower, CFI_index_t& upper, CFI_index_t& stride) {
+    FCPP_CHECK(s.step != 0);
+    const CFI_index_t n = s.step > 0 
+        ? (s.last > s.first ? (s.last - s.first + s.step - 1) / s.step : 0)
+        : (s.first > s.last ? (s.first - s.last - s.step - 1) / (-s.step) : 0);
+    FCPP_CHECK(n == 0 || (0 <= s.first && s.first < ext));
+    FCPP_CHECK(n == 0 || (0 <= s.first + (n-1)*s.step && s.first + (n-1)*s.step < ext));
+    lower = lb + s.first;
+    upper = lower + (n - 1)*s.step;
+    stride = s.step;
+}
+
+template<typename I>
+    requires std::is_integral_v<I>
+void section_bounds(CFI_index_t lb, [[maybe_unused]] CFI_index_t ext, I idx,
+    CFI_index_t& lower, CFI_index_t& upper, CFI_index_t& stride) {
+    FCPP_CHECK(0 <= idx && static_cast<CFI_index_t>(idx) < ext);
+    lower = upper = lb + static_cast<CFI_index_t>(idx);
+    stride = 0;
+}
+
+// Rank of the section produced by the specifiers (integer indices
+// remove a dimension)
+template<typename... Specs>
+inline constexpr int section_rank = ((std::is_integral_v<Specs> ? 0 : 1) + ... + 0);
+
+} // namespace Fcpp_impl_
+
+/**
+ *  Enumerator class for the memory layout
+ *
+ *  A contiguous layout is verified once when the class is constructed,
+ *  after which element access reduces to plain pointer arithmetic.
+ */
+enum class layout {
+    strided,
+    contiguous
+};
+
+#if FCPP_HAS_MDSPAN
+
+namespace Fcpp_impl_ {
+
+// Extents of a std::extents object as an array of CFI_index_t
+template<typename Ext>
+constexpr std::array<CFI_index_t,Ext::rank()> extents_array(const Ext& e) {
+    std::array<CFI_index_t,Ext::rank()> ext;
+    for (std::size_t d = 0; d < Ext::rank(); ++d) {
+        ext[d] = static_cast<CFI_index_t>(e.extent(d));
+    }
+    return ext;
+}
+
+// Extents of a C descriptor as a std::extents object
+template<typename Ext>
+Ext make_extents(const CFI_cdesc_t *desc) {
+    FCPP_CHECK(desc->rank == Ext::rank());
+    std::array<typename Ext::index_type,Ext::rank()> ext;
+    for (std::size_t d = 0; d < Ext::rank(); ++d) {
+        ext[d] = static_cast<typename Ext::index_type>(desc->dim[d].extent);
+    }
+    return Ext(ext);
+}
+
+} // namespace Fcpp_impl_
+
+/**
+ *  Layout mapping policy for std::mdspan following the memory 
+ *  strides (CFI_dim_t::sm) of a Fortran array
+ *
+ *  Unlike std::layout_stride, negative strides are allowed. In that case
+ *  the mapping carries an offset, so the data handle of the mdspan points
+ *  to the element with the lowest address. The Fortran lower bounds are
+ *  retained, but indices remain zero-based as required by std::mdspan.
+ */
+struct layout_fortran_strided {
+
+    template<typename Extents>
+    class mapping {
+    public:
+        using extents_type = Extents;
+        using index_type = typename extents_type::index_type;
+        using size_type = typename extents_type::size_type;
+        using rank_type = typename extents_type::rank_type;
+        using layout_type = layout_fortran_strided;
+
+        static_assert(std::is_signed_v<index_type>,
+            "Index type must be signed to represent negative strides");
+
+        static constexpr rank_type rank_ = extents_type::rank();
+
+        // Column-major strides by default
+        constexpr mapping() noexcept : mapping(extents_type{}) {}
+
+        constexpr mapping(const extents_type& e) noexcept : extents_(e) {
+            index_type s = 1;
+            for (rank_type d = 0; d < rank_; ++d) {
+                strides_[d] = s;
+                s *= extents_.extent(d);
+            }
+        }
+
+        // Strides in units of elements
+        constexpr mapping(const extents_type& e, 
+                const std::array<index_type,rank_>& strides,
+                const std::array<index_type,rank_>& lower_bounds = {}) noexcept
+            : extents_(e), strides_(strides), lower_bounds_(lower_bounds) {
+            for (rank_type d = 0; d < rank_; ++d) {
+                if (strides_[d] < 0 && extents_.extent(d) > 0) {
+                    offset_ -= (extents_.extent(d) - 1)*strides_[d];
+                }
+            }
+        }
+
+        // Mapping of the array described by a C descriptor
+        explicit mapping(const CFI_cdesc_t *desc) 
+            : mapping(Fcpp_impl_::make_extents<extents_type>(desc),
+                      strides_of(desc), lower_bounds_of(desc)) {}
+
+        constexpr const extents_type& extents() const noexcept { return extents_; }
+
+        constexpr index_type required_span_size() const noexcept {
+            index_type span = 1;
+            for (rank_type d = 0; d < rank_; ++d) {
+                if (extents_.extent(d) == 0) return 0;
+                const index_type s = strides_[d] < 0 ? -strides_[d] : strides_[d];
+                span += (extents_.extent(d) - 1)*s;
+            }
+            return span;
+        }
+
+        template<typename... Indices>
+            requires (sizeof...(Indices) == rank_)
+        constexpr index_type operator()(Indices... idx) const noexcept {
+            return [&]<std::size_t... d>(std::index_sequence<d...>) {
+                return (offset_ + ... + 
+                    (static_cast<index_type>(idx)*strides_[d]));
+            }(std::index_sequence_for<Indices...>{});
+        }
+
+        static constexpr bool is_always_unique() noexcept { return true; }
+        static constexpr bool is_always_exhaustive() noexcept { return false; }
+        static constexpr bool is_always_strided() noexcept { return true; }
+
+        static constexpr bool is_unique() noexcept { return true; }
+        constexpr bool is_exhaustive() const noexcept {
+            index_type n = 1;
+            for (rank_type d = 0; d < rank_; ++d) {
+                n *= extents_.extent(d);
+            }
+            return required_span_size() == n;
+        }
+        static constexpr bool is_strided() noexcept { return true; }
+
+        constexpr index_type stride(rank_type r) const noexcept { return strides_[r]; }
+        constexpr index_type lower_bound(rank_type r) const noexcept { return lower_bounds_[r]; }
+
+        // Offset of the first element from the lowest address
+        constexpr index_type offset() const noexcept { return offset_; }
+
+        friend constexpr bool operator==(const mapping& lhs, const mapping& rhs) noexcept {
+            return lhs.extents_ == rhs.extents_ && 
+                   lhs.strides_ == rhs.strides_ && 
+                   lhs.offset_ == rhs.offset_;
+        }
+
+    private:
+        static std::array<index_type,rank_> strides_of(const CFI_cdesc_t *desc) {
+            std::array<index_type,rank_> s;
+            for (rank_type d = 0; d < rank_; ++d) {
+                FCPP_CHECK(desc->dim[d].sm % static_cast<CFI_index_t>(desc->elem_len) == 0);
+                s[d] = static_cast<index_type>(desc->dim[d].sm / 
+                    static_cast<CFI_index_t>(desc->elem_len));
+            }
+            return s;
+        }
+
+        static std::array<index_type,rank_> lower_bounds_of(const CFI_cdesc_t *desc) {
+            std::array<index_type,rank_> lb;
+            for (rank_type d = 0; d < rank_; ++d) {
+                lb[d] = static_cast<index_type>(desc->dim[d].lower_bound);
+            }
+            return lb;
+        }
+
+        extents_type extents_{};
+        std::array<index_type,rank_> strides_{};
+        std::array<index_type,rank_> lower_bounds_{};
+        index_type offset_{0};
+    };
+};
+
+#endif
+
+template<typename T, int rank_>
+class cdesc_view;
+
+namespace Fcpp_impl_ {
+
+// Lazy elementwise expression, see Fcpp/expressions.h
+template<typename E>
+concept array_expression = requires { typename E::expression_tag; };
+
+// Containers from other libraries, for the zero-copy cdesc constructors.
+// Classes with a descriptor of their own are never treated as such.
+template<typename U>
+concept has_descriptor = requires (const U& u) {
+    { u.get() } -> std::convertible_to<const CFI_cdesc_t *>;
+};
+
+// Matrix classes with rows(), cols() and data(), column-major unless 
+// M::IsRowMajor is set, with innerStride() and outerStride() if 
+// present (e.g. Eigen::Matrix, Eigen::Map and Eigen::Block)
+template<typename M, typename T>
+concept matrix_like = !has_descriptor<M> && requires (M& m) {
+    { m.data() } -> std::convertible_to<T*>;
+    { m.rows() } -> std::integral;
+    { m.cols() } -> std::integral;
+};
+
+// Multidimensional views with data(), extent(r), stride(r) and a static
+// rank (e.g. Kokkos::View with LayoutLeft or LayoutStride)
+template<typename V, typename T>
+concept strided_view_like = !has_descriptor<V> && !matrix_like<V,T> && 
+    requires (const V& v) {
+        { v.data() } -> std::convertible_to<T*>;
+        { v.extent(0) } -> std::integral;
+        { v.stride(0) } -> std::integral;
+        static_cast<int>(V::rank);
+    };
+
+// Any other contiguous range of T that does not own its elements
+// through a temporary (e.g. std::valarray, std::ranges::subrange)
+template<typename R, typename T>
+concept foreign_range = !has_descriptor<std::remove_cvref_t<R>> &&
+    !matrix_like<std::remove_reference_t<R>,T> &&
+    std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+    std::ranges::borrowed_range<R> &&
+    std::convertible_to<decltype(std::ranges::data(std::declval<R&>())),T*>;
+
+// Memory strides (in elements) of the rows and columns of a matrix_like
+template<typename M>
+std::array<std::ptrdiff_t,2> matrix_strides(const M& m) {
+    bool row_major = false;
+    if constexpr (requires { M::IsRowMajor; }) row_major = M::IsRowMajor;
+    std::ptrdiff_t inner = 1;
+    std::ptrdiff_t outer = static_cast<std::ptrdiff_t>(row_major ? m.cols() : m.rows());
+    if constexpr (requires { m.innerStride(); m.outerStride(); }) {
+        inner = static_cast<std::ptrdiff_t>(m.innerStride());
+        outer = static_cast<std::ptrdiff_t>(m.outerStride());
+    }
+    if (row_major) return {outer, inner};
+    return {inner, outer};
+}
+
+} // namespace Fcpp_impl_
 
 /**
  *  C++-descriptor class encapsulating Fortran array
@@ -88,6 +869,8 @@ public:
     static_assert(rank_ >= 0, "Rank must be non-negative");
     static_assert(rank_ <= CFI_MAX_RANK, 
         "The maximum allowed rank is 15");
+    static_assert(Fcpp_impl_::is_supported_type<T>,
+        "The type has no interoperable kind on this platform");
 
     using value_type = T;
     using size_type = std::size_t;
@@ -118,18 +901,66 @@ public:
             static_cast<CFI_index_t>(n0),
             static_cast<CFI_index_t>(exts)... };
 
-        [[maybe_unused]] int status = CFI_establish(
-            this->get(),
-            ptr,
-            static_cast<attribute_type>(attr_),
-            this->type(),
-            sizeof(T),
-            rank_,
-            extents
-        );
+        this->establish(ptr,extents);
+    }
+
+    // Constructor for arrays whose leading dimension is padded,
+    // i.e. stored with ld.value >= n0 elements
+    template<typename... Exts>
+    cdesc(T* ptr, leading_dim ld, int n0, Exts&&... exts) {
+        static_assert(attr_ == Fcpp::attr::other);
+        static_assert(rank_ == sizeof...(exts) + 1,
+            "Number of extents must be equal to the rank");
+
+        CFI_index_t extents[rank_] = { 
+            static_cast<CFI_index_t>(n0),
+            static_cast<CFI_index_t>(exts)... };
+
+        [[maybe_unused]] int status = Fcpp_impl_::establish_padded<rank_>(
+            this->get(), const_cast<std::remove_const_t<T>*>(ptr), 
+            static_cast<attribute_type>(attr_), this->type(),
+            sizeof(T), ld.value, extents);
+        FCPP_CHECK(status == CFI_SUCCESS);
+        FCPP_RECORD(establish,this->get());
+
+        this->update_strides();
+    }
+
+    // Constructor of an unallocated allocatable array, 
+    // or a disassociated pointer array
+    cdesc() requires (attr_ != Fcpp::attr::other) {
+        this->establish(nullptr,nullptr);
+    }
+
+    // An allocatable descriptor owns its allocation,
+    // so it can be moved but not copied
+    cdesc(const cdesc&) requires (attr_ != Fcpp::attr::allocatable) = default;
+    cdesc& operator=(const cdesc&) requires (attr_ != Fcpp::attr::allocatable) = default;
 
-        assert(status == CFI_SUCCESS);
+    cdesc(cdesc&& other) noexcept requires (attr_ == Fcpp::attr::allocatable)
+        : desc_(other.desc_), sm_(other.sm_) {
+        other.get()->base_addr = nullptr;
+    }
+    cdesc& operator=(cdesc&& other) noexcept requires (attr_ == Fcpp::attr::allocatable) {
+        if (this != &other) {
+            Fcpp_impl_::deallocate(this->get());
+            desc_ = other.desc_;
+            sm_ = other.sm_;
+            other.get()->base_addr = nullptr;
+        }
+        return *this;
+    }
 
+    ~cdesc() requires (attr_ == Fcpp::attr::allocatable) {
+        Fcpp_impl_::deallocate(this->get());
+    }
+    ~cdesc() = default;
+
+    // Evaluate an elementwise expression (Fcpp/expressions.h) into the elements
+    template<Fcpp_impl_::array_expression E>
+    cdesc& operator=(const E& e) requires (!std::is_const_v<T>) {
+        e.assign_to(*this);
+        return *this;
     }
 
     // Constructor for static array
@@ -141,7 +972,18 @@ public:
     }
 
     // Constructor from std::vector
-    cdesc(std::vector<T> &buffer) : cdesc(buffer.data(),buffer.size()) {
+    template<typename Alloc>
+    cdesc(std::vector<T,Alloc> &buffer) : cdesc(buffer.data(),buffer.size()) {
+        static_assert(attr_ == Fcpp::attr::other);
+        static_assert(rank_ == 1,
+            "Rank must be equal to 1 to construct descriptor from std::vector");
+    }
+
+    // Read-only descriptor of a const std::vector
+    template<typename Alloc>
+        requires std::is_const_v<T>
+    cdesc(const std::vector<std::remove_const_t<T>,Alloc> &buffer) 
+        : cdesc(buffer.data(),buffer.size()) {
         static_assert(attr_ == Fcpp::attr::other);
         static_assert(rank_ == 1,
             "Rank must be equal to 1 to construct descriptor from std::vector");
@@ -155,6 +997,23 @@ public:
             "Rank must be equal to 1 to construct descriptor from std::array");
     }
 
+    template<std::size_t N>
+        requires std::is_const_v<T>
+    cdesc(const std::array<std::remove_const_t<T>,N> &buffer) : cdesc(buffer.data(),N) {
+        static_assert(attr_ == Fcpp::attr::other);
+        static_assert(rank_ == 1,
+            "Rank must be equal to 1 to construct descriptor from std::array");
+    }
+
+    // Read-only copy of a descriptor of non-const elements
+    template<typename U>
+        requires (std::is_const_v<T> && std::is_same_v<const U,T> && 
+                  attr_ == Fcpp::attr::other)
+    cdesc(const cdesc<U,rank_,attr_>& other) {
+        std::memcpy(&desc_,other.get(),sizeof(desc_));
+        this->update_strides();
+    }
+
 #if __cpp_lib_span
     cdesc(std::span<T> buffer) : cdesc(buffer.data(),buffer.size()) {
         static_assert(attr_ == Fcpp::attr::other);
@@ -163,11 +1022,129 @@ public:
     }
 #endif
 
+    // Zero-copy constructor from other contiguous ranges, e.g. std::valarray
+    template<typename R>
+        requires Fcpp_impl_::foreign_range<R,T>
+    cdesc(R&& range) : cdesc(std::ranges::data(range),std::ranges::size(range)) {
+        static_assert(attr_ == Fcpp::attr::other);
+        static_assert(rank_ == 1,
+            "Rank must be equal to 1 to construct descriptor from a range");
+    }
+
+    // Zero-copy constructor from a column-major matrix (e.g. Eigen). The 
+    // columns may be padded (outer stride), but the rows must have unit 
+    // stride. With rank 1, the matrix must have a single row or column.
+    template<typename M>
+        requires Fcpp_impl_::matrix_like<std::remove_reference_t<M>,T>
+    cdesc(M&& m) {
+        static_assert(attr_ == Fcpp::attr::other);
+        static_assert(rank_ == 1 || rank_ == 2,
+            "Rank must be 1 or 2 to construct descriptor from a matrix");
+        const auto rows = static_cast<CFI_index_t>(m.rows());
+        const auto cols = static_cast<CFI_index_t>(m.cols());
+        const auto [rs, cs] = Fcpp_impl_::matrix_strides(m);
+        if constexpr (rank_ == 1) {
+            FCPP_CHECK(rows == 1 || cols == 1);
+            const CFI_index_t n = rows*cols;
+            FCPP_CHECK(n <= 1 || (cols == 1 ? rs : cs) == 1);
+            this->establish(m.data(),&n);
+        } else {
+            FCPP_CHECK(rows <= 1 || rs == 1);
+            const CFI_index_t extents[2] = {rows, cols};
+            this->establish(m.data(),extents);
+            if (cols > 1) this->restride(std::array<std::ptrdiff_t,2>{1, cs});
+        }
+    }
+
+    // Zero-copy constructor from a strided multidimensional view 
+    // (e.g. Kokkos::View); the leading dimension must have unit stride
+    template<typename V>
+        requires Fcpp_impl_::strided_view_like<std::remove_reference_t<V>,T>
+    cdesc(V&& view) {
+        static_assert(attr_ == Fcpp::attr::other);
+        static_assert(static_cast<int>(std::remove_reference_t<V>::rank) == rank_,
+            "Rank of the view must match the rank of the descriptor");
+        std::array<CFI_index_t,(rank_ > 0 ? rank_ : 1)> extents{};
+        std::array<std::ptrdiff_t,rank_> strides{};
+        for (int d = 0; d < rank_; ++d) {
+            extents[d] = static_cast<CFI_index_t>(view.extent(d));
+            strides[d] = static_cast<std::ptrdiff_t>(view.stride(d));
+        }
+        this->establish(view.data(),extents.data());
+        this->restride(strides);
+    }
+
+
+#if FCPP_HAS_MDSPAN
+    // Zero-copy constructors from std::mdspan. The leading dimension
+    // must have unit stride; the remaining ones may be padded.
+    template<typename Ext, typename Acc>
+    cdesc(std::mdspan<T,Ext,std::layout_left,Acc> buffer) {
+        static_assert(attr_ == Fcpp::attr::other);
+        static_assert(std::is_same_v<typename Acc::data_handle_type,T*>);
+        static_assert(Ext::rank() == rank_, 
+            "Rank of std::mdspan must match the rank of the descriptor");
+        auto extents = Fcpp_impl_::extents_array(buffer.extents());
+        this->establish(buffer.data_handle(),extents.data());
+    }
+
+    template<typename Ext, typename Acc>
+    cdesc(std::mdspan<T,Ext,std::layout_stride,Acc> buffer) {
+        static_assert(attr_ == Fcpp::attr::other);
+        static_assert(std::is_same_v<typename Acc::data_handle_type,T*>);
+        static_assert(Ext::rank() == rank_, 
+            "Rank of std::mdspan must match the rank of the descriptor");
+        auto extents = Fcpp_impl_::extents_array(buffer.extents());
+        this->establish(buffer.data_handle(),extents.data());
+        this->restride(buffer.mapping());
+    }
 
-#if __cpp_lib_mdspan
-    cdesc(std::mdspan<T,std::dextents<rank_>,std::layout_left> buffer) {
+    template<typename Ext, typename Acc>
+    cdesc(std::mdspan<T,Ext,layout_fortran_strided,Acc> buffer) {
         static_assert(attr_ == Fcpp::attr::other);
-        static_assert(rank_ > 1, "Rank must be higher than 1 to convert to std::mdspan");
+        static_assert(std::is_same_v<typename Acc::data_handle_type,T*>);
+        static_assert(Ext::rank() == rank_, 
+            "Rank of std::mdspan must match the rank of the descriptor");
+        auto extents = Fcpp_impl_::extents_array(buffer.extents());
+        this->establish(buffer.data_handle() + buffer.mapping().offset(),
+            extents.data());
+        this->restride(buffer.mapping());
+    }
+
+    // Conversion to std::mdspan (a column-major view); std::layout_stride
+    // requires positive strides, for reversed dimensions view the array
+    // through cdesc_ptr::to_mdspan (layout_fortran_strided) instead
+    template<typename Ext = std::dextents<CFI_index_t,rank_>>
+    std::mdspan<T,Ext,std::layout_stride> to_mdspan() const {
+        static_assert(Ext::rank() == rank_, 
+            "Rank of std::mdspan must match the rank of the descriptor");
+        using index_type = typename Ext::index_type;
+        const auto sm = this->strides();
+        std::array<index_type,rank_> strides;
+        for (int d = 0; d < rank_; ++d) {
+            // The stride of a dimension with at most one element is never used
+            if (sm[d] <= 0 && this->extent(d) <= 1) {
+                strides[d] = 1;
+                continue;
+            }
+            FCPP_CHECK(sm[d] > 0);
+            strides[d] = static_cast<index_type>(sm[d]);
+        }
+        return {static_cast<T*>(get()->base_addr), std::layout_stride::mapping<Ext>(
+            Fcpp_impl_::make_extents<Ext>(get()), strides)};
+    }
+
+    template<typename Ext>
+    operator std::mdspan<T,Ext,std::layout_stride>() const {
+        return this->to_mdspan<Ext>();
+    }
+
+    template<typename Ext>
+    operator std::mdspan<T,Ext,std::layout_left>() const {
+        static_assert(Ext::rank() == rank_, 
+            "Rank of std::mdspan must match the rank of the descriptor");
+        FCPP_CHECK(this->is_contiguous());
+        return {static_cast<T*>(get()->base_addr), Fcpp_impl_::make_extents<Ext>(get())};
     }
 #endif
 
@@ -176,39 +1153,162 @@ public:
     constexpr auto get() const { return get_descptr(); }
 
     inline std::size_t extent(int dim) const {
-        assert(0 <= dim && dim < rank_);
+        FCPP_CHECK_BOUNDS(0 <= dim && dim < rank_);
         return this->get()->dim[dim].extent;
     }
 
     bool is_contiguous() const {
+        FCPP_RECORD(contiguity_check,this->get());
         return CFI_is_contiguous(this->get()) > 0;
     }
 
-    // Implicit cast to C-descriptor pointer
-    operator CFI_cdesc_t* () { return this->get(); }
+    // Point the descriptor to other storage of the same shape. The type,
+    // rank and attribute were validated on construction, so the base 
+    // address is written directly instead of calling CFI_establish again.
+    void rebind(T* ptr) noexcept requires (attr_ == Fcpp::attr::other) {
+        this->get()->base_addr = ptr;
+    }
+
+    // Change the extents in place, giving a contiguous column-major
+    // array (any padding of the leading dimension is dropped)
+    template<typename... Exts>
+    void reshape(Exts... exts) noexcept requires (attr_ == Fcpp::attr::other) {
+        static_assert(sizeof...(Exts) == rank_,
+            "Number of extents must be equal to the rank");
+        const CFI_index_t extents[rank_ > 0 ? rank_ : 1] = { static_cast<CFI_index_t>(exts)... };
+        CFI_index_t sm = 1;
+        for (int d = 0; d < rank_; ++d) {
+            this->get()->dim[d].lower_bound = 0;
+            this->get()->dim[d].extent = extents[d];
+            this->get()->dim[d].sm = sm*static_cast<CFI_index_t>(sizeof(T));
+            sm_[d] = sm;
+            sm *= extents[d];
+        }
+    }
+
+    template<typename... Exts>
+    void rebind(T* ptr, Exts... exts) noexcept requires (attr_ == Fcpp::attr::other) {
+        this->rebind(ptr);
+        this->reshape(exts...);
+    }
 
-    // FIXME: We need a proper iterator to handle the non-contiguous case
-    //        when the stride memory is larger than the element size.
+    // Allocation status (allocatable and pointer arrays)
+    bool is_allocated() const { return this->get()->base_addr != nullptr; }
+
+    // Allocate through the Fortran runtime (CFI_allocate), so the array
+    // may also be deallocated or reallocated on the Fortran side
+    template<typename... Exts>
+    void allocate(Exts... exts) requires (attr_ != Fcpp::attr::other) {
+        static_assert(sizeof...(Exts) == rank_,
+            "Number of extents must be equal to the rank");
+        CFI_index_t extents[rank_ > 0 ? rank_ : 1] = { static_cast<CFI_index_t>(exts)... };
+        Fcpp_impl_::allocate<rank_>(this->get(),extents);
+        this->update_strides();
+    }
+
+    void deallocate() requires (attr_ != Fcpp::attr::other) {
+        Fcpp_impl_::deallocate(this->get());
+    }
+
+    // Reallocate unless the extents are unchanged;
+    // the contents are not preserved
+    template<typename... Exts>
+    void resize(Exts... exts) requires (attr_ != Fcpp::attr::other) {
+        static_assert(sizeof...(Exts) == rank_,
+            "Number of extents must be equal to the rank");
+        CFI_index_t extents[rank_ > 0 ? rank_ : 1] = { static_cast<CFI_index_t>(exts)... };
+        Fcpp_impl_::reallocate<rank_>(this->get(),extents);
+        this->update_strides();
+    }
+
+    // Implicit cast to C-descriptor pointer
+    operator CFI_cdesc_t* () const { return this->get(); }
 
     // Array subscript operators
     T& operator[](std::size_t idx) {
         static_assert(rank_ == 1,
             "Rank must be 1 to use array subscript operator");
+            FCPP_CHECK_BOUNDS(Fcpp_impl_::in_bounds(get(),idx));
             return *(data() + idx);
         }
     const T& operator[](std::size_t idx) const {
         static_assert(rank_ == 1,
             "Rank must be 1 to use array subscript operator");
+        FCPP_CHECK_BOUNDS(Fcpp_impl_::in_bounds(get(),idx));
         return *(data() + idx);
     }
 
-    constexpr pointer data() const { return static_cast<pointer>(get()->base_addr); }
+    // Multidimensional-access operator (zero-based, column-major)
+    template<typename... Idx>
+    T& operator()(Idx... idx) {
+        FCPP_CHECK_BOUNDS(Fcpp_impl_::in_bounds(get(),idx...));
+        return data()[Fcpp_impl_::linear_offset<true>(strides(), idx...)];
+    }
+    template<typename... Idx>
+    const T& operator()(Idx... idx) const {
+        FCPP_CHECK_BOUNDS(Fcpp_impl_::in_bounds(get(),idx...));
+        return data()[Fcpp_impl_::linear_offset<true>(strides(), idx...)];
+    }
+
+#if __cpp_multidimensional_subscript >= 202110L
+    template<typename... Idx>
+        requires (sizeof...(Idx) != 1)
+    T& operator[](Idx... idx) { return this->operator()(idx...); }
+    template<typename... Idx>
+        requires (sizeof...(Idx) != 1)
+    const T& operator[](Idx... idx) const { return this->operator()(idx...); }
+#endif
+
+    // The elements of a cdesc are const when the cdesc is, as for the 
+    // standard containers; sections and the descriptor itself are views
+    constexpr pointer data() { return static_cast<pointer>(get()->base_addr); }
+    constexpr const_pointer data() const { return static_cast<const_pointer>(get()->base_addr); }
+
+    // Array section, see full_extent and slice
+    template<typename... Specs>
+    cdesc_view<T,Fcpp_impl_::section_rank<Specs...>> section(Specs... specs) const {
+        static_assert(sizeof...(Specs) == rank_,
+            "Number of section specifiers must be equal to the rank");
+        return cdesc_view<T,Fcpp_impl_::section_rank<Specs...>>::section_of(get(),specs...);
+    }
+
+    // Component of an array of structures, e.g. a.part(&particle::x)
+    template<typename U, typename S>
+        requires std::is_same_v<S,T>
+    cdesc_view<U,rank_> part(U S::* member) const {
+        return cdesc_view<U,rank_>::part_of(get(),member);
+    }
+
+    // Pointer to the data, with the promise that it is aligned 
+    // to N bytes (e.g. to enable aligned vector loads)
+    template<std::size_t N>
+    pointer aligned_data() {
+        FCPP_CHECK(reinterpret_cast<std::uintptr_t>(data()) % N == 0);
+        return std::assume_aligned<N>(data());
+    }
+    template<std::size_t N>
+    const_pointer aligned_data() const {
+        FCPP_CHECK(reinterpret_cast<std::uintptr_t>(data()) % N == 0);
+        return std::assume_aligned<N>(data());
+    }
+
+    // Number of elements
+    size_type size() const {
+        size_type n = 1;
+        for (int d = 0; d < rank_; ++d) {
+            n *= this->extent(d);
+        }
+        return n;
+    }
+    bool empty() const { return this->size() == 0; }
 
     // Iterator support
-    T* begin() { return &this->operator[](0); }
-    T* end() { return &this->operator[](this->get()->dim[0].extent); }
-    const T* cbegin() { return &this->operator[](0); }
-    const T* cend() { return &this->operator[](this->get()->dim[0].extent); }
+    T* begin() requires (rank_ == 1) { return data(); }
+    T* end() requires (rank_ == 1) { return data() + this->size(); }
+    const T* begin() const requires (rank_ == 1) { return data(); }
+    const T* end() const requires (rank_ == 1) { return data() + this->size(); }
+    const T* cbegin() const requires (rank_ == 1) { return begin(); }
+    const T* cend() const requires (rank_ == 1) { return end(); }
 
 private:
 
@@ -218,18 +1318,100 @@ private:
         return (CFI_cdesc_t *) &desc_;
     } 
 
+    void establish(T* ptr, const CFI_index_t extents[]) {
+
+        // A null address would denote an unallocated array, and empty
+        // containers may well return one from data()
+        if constexpr (attr_ == Fcpp::attr::other) {
+            if (!ptr) ptr = static_cast<T*>(Fcpp_impl_::empty_base_addr());
+        }
+
+        // Descriptors of const elements (intent(in) arrays) 
+        // store the address like the others
+        [[maybe_unused]] int status = CFI_establish(
+            this->get(),
+            const_cast<std::remove_const_t<T>*>(ptr),
+            static_cast<attribute_type>(attr_),
+            this->type(),
+            sizeof(T),
+            rank_,
+            extents
+        );
+
+        FCPP_CHECK(status == CFI_SUCCESS);
+        FCPP_RECORD(establish,this->get());
+
+        this->update_strides();
+    }
+
+    void update_strides() {
+        // The dimensions of unallocated arrays are undefined
+        if (!this->get()->base_addr) {
+            sm_.fill(1);
+            return;
+        }
+        for (int d = 0; d < rank_; ++d) {
+            sm_[d] = this->get()->dim[d].sm / static_cast<CFI_index_t>(sizeof(T));
+        }
+    }
+
+    // Element strides; allocatable and pointer arrays may be reallocated
+    // on the Fortran side, so for these the descriptor is read instead
+    std::array<std::ptrdiff_t,rank_> strides() const {
+        if constexpr (attr_ == Fcpp::attr::other) {
+            return sm_;
+        } else {
+            std::array<std::ptrdiff_t,rank_> sm;
+            for (int d = 0; d < rank_; ++d) {
+                sm[d] = this->get()->dim[d].sm / static_cast<CFI_index_t>(sizeof(T));
+            }
+            return sm;
+        }
+    }
+
+    // Overwrite the memory strides established for a contiguous array
+    // with element strides (the first one must be unit, as assumed by
+    // the element access); empty dimensions keep their strides
+    void restride(const std::array<std::ptrdiff_t,rank_>& strides) {
+        if (!this->get()->base_addr) return;
+        for (int d = 0; d < rank_; ++d) {
+            if (this->get()->dim[d].extent <= 1) continue;
+            FCPP_CHECK(d > 0 || strides[0] == 1);
+            sm_[d] = strides[d];
+            this->get()->dim[d].sm = sm_[d]*static_cast<CFI_index_t>(sizeof(T));
+        }
+    }
+
+#if FCPP_HAS_MDSPAN
+    // Same with the strides of a strided layout mapping
+    template<typename Mapping>
+    void restride(const Mapping& map) {
+        std::array<std::ptrdiff_t,rank_> strides;
+        for (int d = 0; d < rank_; ++d) {
+            strides[d] = static_cast<std::ptrdiff_t>(map.stride(d));
+        }
+        this->restride(strides);
+    }
+#endif
+
 private:
     // Descriptor containing the actual data
     CFI_CDESC_T(rank_) desc_;
+
+    // Element strides, computed once on construction
+    std::array<std::ptrdiff_t,rank_> sm_{};
 };
 
-template<typename T, int rank_, attr attr_ = Fcpp::attr::other>
+template<typename T, int rank_, attr attr_ = Fcpp::attr::other,
+         layout layout_ = Fcpp::layout::strided>
 class cdesc_ptr {
 public:
 
     static_assert(rank_ >= 0, "Rank must be non-negative");
     static_assert(rank_ <= CFI_MAX_RANK, 
         "The maximum allowed rank is 15");
+    static_assert(Fcpp_impl_::is_supported_type<T>,
+        "The type has no interoperable kind on this platform");
 
     using value_type = T;
     using size_type = std::size_t;
@@ -247,6 +1429,13 @@ public:
     // (the name get() is inspired by the C++ smart pointer classes)
     constexpr auto get() const { return get_descptr(); }
 
+    // Evaluate an elementwise expression (Fcpp/expressions.h) into the elements
+    template<Fcpp_impl_::array_expression E>
+    cdesc_ptr& operator=(const E& e) requires (!std::is_const_v<T>) {
+        e.assign_to(*this);
+        return *this;
+    }
+
     // Version of ISO_Fortran_binding.h 
     constexpr int version() const { return this->get()->version; }
 
@@ -254,7 +1443,7 @@ public:
     std::size_t elem_len() const { return this->get()->elem_len; }
 
     inline std::size_t extent(int d) const {
-        assert(0 <= d && d < rank_);
+        FCPP_CHECK_BOUNDS(0 <= d && d < rank_);
         return this->get()->dim[d].extent;
     }
 
@@ -267,102 +1456,196 @@ public:
     // Constructor
     cdesc_ptr(CFI_cdesc_t *ptr) : ptr_(ptr) {
         // Runtime assertions
-        assert(ptr_->type == type());
-        assert(ptr_->rank == rank());
-        assert(ptr_->attribute == (CFI_attribute_t) attr_);
+        FCPP_CHECK(Fcpp_impl_::type_matches<T>(ptr_));
+        FCPP_CHECK(ptr_->rank == rank());
+        FCPP_CHECK(ptr_->attribute == (CFI_attribute_t) attr_);
+
+        this->update_strides();
+    }
+
+    // Read-only access to a descriptor, e.g. an intent(in) dummy argument
+    cdesc_ptr(const CFI_cdesc_t *ptr) requires std::is_const_v<T>
+        : cdesc_ptr(const_cast<CFI_cdesc_t *>(ptr)) {}
+
+    template<typename U, layout other_layout_>
+        requires (std::is_const_v<T> && std::is_same_v<const U,T> &&
+                  (layout_ == other_layout_ || layout_ == Fcpp::layout::strided))
+    cdesc_ptr(const cdesc_ptr<U,rank_,attr_,other_layout_>& other) 
+        : cdesc_ptr(other.get()) {}
+
+    // Allocation status (allocatable and pointer arrays)
+    bool is_allocated() const { return ptr_->base_addr != nullptr; }
+
+    // Allocate through the Fortran runtime (CFI_allocate)
+    template<typename... Exts>
+    void allocate(Exts... exts) requires (attr_ != Fcpp::attr::other) {
+        static_assert(sizeof...(Exts) == rank_,
+            "Number of extents must be equal to the rank");
+        CFI_index_t extents[rank_ > 0 ? rank_ : 1] = { static_cast<CFI_index_t>(exts)... };
+        Fcpp_impl_::allocate<rank_>(ptr_,extents);
+        this->update_strides();
+    }
+
+    void deallocate() requires (attr_ != Fcpp::attr::other) {
+        Fcpp_impl_::deallocate(ptr_);
+    }
+
+    // Reallocate unless the extents are unchanged;
+    // the contents are not preserved
+    template<typename... Exts>
+    void resize(Exts... exts) requires (attr_ != Fcpp::attr::other) {
+        static_assert(sizeof...(Exts) == rank_,
+            "Number of extents must be equal to the rank");
+        CFI_index_t extents[rank_ > 0 ? rank_ : 1] = { static_cast<CFI_index_t>(exts)... };
+        Fcpp_impl_::reallocate<rank_>(ptr_,extents);
+        this->update_strides();
     }
 
-    // Assumed-size constructor
-    //cdesc_ptr(CFI_cdesc_t *ptr, int n) {
-    //    assert(ptr_->rank == rank_);
-    //    assert(ptr_->extents[rank_-1] == -1);
-    //    // TODO: check array is really assumed size
-    //}
+    // Move the allocation to another allocatable array, like the
+    // Fortran intrinsic MOVE_ALLOC; afterwards this array is unallocated
+    template<layout other_layout_>
+    void move_alloc(cdesc_ptr<T,rank_,attr_,other_layout_>& to) 
+        requires (attr_ == Fcpp::attr::allocatable) {
+        CFI_cdesc_t *dst = to.get();
+        if (dst == ptr_) return;
+        Fcpp_impl_::deallocate(dst);
+        dst->base_addr = ptr_->base_addr;
+        for (int d = 0; d < rank_; ++d) {
+            dst->dim[d] = ptr_->dim[d];
+        }
+        ptr_->base_addr = nullptr;
+        to = cdesc_ptr<T,rank_,attr_,other_layout_>(dst);
+    }
+
+    // Assumed-size arrays (an actual argument a(n,*) passed to an 
+    // assumed-rank dummy) have extent -1 in the last dimension; their 
+    // size must come from elsewhere, see cdesc_view::assumed_size
+    bool is_assumed_size() const {
+        if constexpr (rank_ == 0) {
+            return false;
+        } else {
+            return ptr_->dim[rank_-1].extent == -1;
+        }
+    }
 
     bool is_contiguous() const {
-        return CFI_is_contiguous(this->get()) > 0;
+        if constexpr (layout_ == Fcpp::layout::contiguous) {
+            return true;
+        } else {
+            FCPP_RECORD(contiguity_check,this->get());
+            return CFI_is_contiguous(this->get()) > 0;
+        }
     }
 
     constexpr pointer data() const {
-        assert(this->is_contiguous());
+        if constexpr (layout_ != Fcpp::layout::contiguous) {
+            FCPP_CHECK(this->is_contiguous());
+        }
         return static_cast<pointer>(ptr_->base_addr); 
     }
 
     // Array subscript operators
-    // TODO: multidimensional-access operator
-    // TODO: make variadic
     T& operator[](std::size_t idx) {
         static_assert(rank_ == 1,
             "Rank must be 1 to use array subscript operator");
-            return *(base_addr() + idx*(stride<0>()/sizeof(T)));
+            FCPP_CHECK_BOUNDS(Fcpp_impl_::in_bounds(ptr_,idx));
+            return base_addr()[static_cast<std::ptrdiff_t>(idx)*elem_stride<0>()];
         }
     const T& operator[](std::size_t idx) const {
         static_assert(rank_ == 1,
             "Rank must be 1 to use array subscript operator");
-        return *(base_addr() + idx*(stride<0>()/sizeof(T)));
+        FCPP_CHECK_BOUNDS(Fcpp_impl_::in_bounds(ptr_,idx));
+        return base_addr()[static_cast<std::ptrdiff_t>(idx)*elem_stride<0>()];
     }
 
-    struct Iterator {
-        using iterator_category = std::random_access_iterator_tag;
-        using difference_type   = std::ptrdiff_t;
-        using value_type        = T;
-        using pointer           = T*;
-        using reference         = T&;
+    // Multidimensional-access operator (zero-based, column-major)
+    template<typename... Idx>
+    T& operator()(Idx... idx) {
+        FCPP_CHECK_BOUNDS(Fcpp_impl_::in_bounds(ptr_,idx...));
+        return base_addr()[Fcpp_impl_::linear_offset<unit_stride>(sm_, idx...)];
+    }
+    template<typename... Idx>
+    const T& operator()(Idx... idx) const {
+        FCPP_CHECK_BOUNDS(Fcpp_impl_::in_bounds(ptr_,idx...));
+        return base_addr()[Fcpp_impl_::linear_offset<unit_stride>(sm_, idx...)];
+    }
 
-        Iterator(pointer ptr, CFI_index_t sm) : ptr_(ptr), stride(sm/sizeof(T)) {}
+#if __cpp_multidimensional_subscript >= 202110L
+    template<typename... Idx>
+        requires (sizeof...(Idx) != 1)
+    T& operator[](Idx... idx) { return this->operator()(idx...); }
+    template<typename... Idx>
+        requires (sizeof...(Idx) != 1)
+    const T& operator[](Idx... idx) const { return this->operator()(idx...); }
+#endif
 
-        reference operator*() const { return *ptr_; }
-        pointer operator->() { return ptr_; }
-        Iterator& operator++() { 
-            ptr_ = ptr_ + stride; 
-            return *this; 
-        }
-        Iterator operator++(int) { 
-            Iterator tmp = *this;
-            ++(*this);
-            return tmp;
+    // Contiguous arrays are iterated using plain pointers
+    using iterator = std::conditional_t<layout_ == Fcpp::layout::contiguous,
+        T*, Fcpp_impl_::strided_iterator<T>>;
+    using const_iterator = std::conditional_t<layout_ == Fcpp::layout::contiguous,
+        const T*, Fcpp_impl_::strided_iterator<const T>>;
+    using Iterator = iterator;
+
+    // Number of elements
+    size_type size() const {
+        size_type n = 1;
+        for (int d = 0; d < rank_; ++d) {
+            n *= this->extent(d);
         }
-        bool operator==(const Iterator& rhs) const {
-            return ptr_ == rhs.ptr_;
+        return n;
+    }
+    bool empty() const { return this->size() == 0; }
+
+    // Iterator support (rank-1 arrays)
+    iterator begin() const requires (rank_ == 1) { 
+        if constexpr (layout_ == Fcpp::layout::contiguous) {
+            return base_addr();
+        } else {
+            if (elem_stride<0>() != 1) FCPP_RECORD(strided_iteration,ptr_);
+            return iterator(base_addr(), elem_stride<0>()); 
         }
-        bool operator!=(const Iterator& rhs) const {
-            return ptr_ != rhs.ptr_;
+    }
+    iterator end() const requires (rank_ == 1) { 
+        if constexpr (layout_ == Fcpp::layout::contiguous) {
+            return base_addr() + extent<0>();
+        } else {
+            return iterator(base_addr(), elem_stride<0>()) + extent<0>(); 
         }
+    }
+    const_iterator cbegin() const requires (rank_ == 1) { return begin(); }
+    const_iterator cend() const requires (rank_ == 1) { return end(); }
+
+    // Array section, see full_extent and slice
+    template<typename... Specs>
+    cdesc_view<T,Fcpp_impl_::section_rank<Specs...>> section(Specs... specs) const {
+        static_assert(sizeof...(Specs) == rank_,
+            "Number of section specifiers must be equal to the rank");
+        return cdesc_view<T,Fcpp_impl_::section_rank<Specs...>>::section_of(get(),specs...);
+    }
 
-    private:
-        pointer ptr_;
-        const size_t stride;
-    };
-
-    // Iterator support
-    Iterator begin() { 
-        static_assert(rank_ == 1, "Rank must be one to use iterator");
-        return Iterator(base_addr(), this->stride<0>()); 
+    // Component of an array of structures, e.g. a.part(&particle::x)
+    template<typename U, typename S>
+        requires std::is_same_v<S,T>
+    cdesc_view<U,rank_> part(U S::* member) const {
+        return cdesc_view<U,rank_>::part_of(get(),member);
     }
-    Iterator end() { 
-        static_assert(rank_ == 1, "Rank must be one to use iterator");
-        std::size_t nbytes = extent<0>()*(stride<0>()/sizeof(T));
-        return Iterator(base_addr() + nbytes, this->stride<0>()); 
-    }    
 
 #if __cpp_lib_span
     // Implicit cast to std::span (only for rank-1 arrays, 
     // otherwise use .flatten())
     //
-    // TODO: compile-time contiguity check
+    // Contiguity is checked at run time, unless the layout is
+    // known to be contiguous.
     operator std::span<T>() const {
         static_assert(rank_ == 1,
             "Rank must be equal to 1 to convert implicitly to std::span");
-        assert(this->is_contiguous())
         size_type n = this->get()->dim[0].extent;
         return {this->data(),n};
     }
     // Return a flattened view of the array.
     // TODO: handle assumed-size arrays
-    // TODO: compile-time contiguity check
-    std::span<T> flatten() {
+    std::span<T> flatten() const {
         static_assert(rank_ > 1, "Rank must be higher than 1 to use .flatten()");
-        assert(this->is_contiguous())
         size_type nelem = 1;
         for (int i = 0; i < rank_; ++i) {
             nelem *= this->extent(i);
@@ -371,19 +1654,79 @@ public:
     }
 #endif
 
-#if __cpp_lib_mdspan
-    operator std::mdspan<T,std::dextents<rank_>>() const {
-        static_assert(rank_ > 1, "Rank must be higher than 1 to convert to std::mdspan");
-        return {this->data_handle(), extents... };
+#if FCPP_HAS_MDSPAN
+    // Zero-copy view as std::mdspan, following the memory strides of 
+    // the descriptor (including negative ones)
+    template<typename Ext = std::dextents<CFI_index_t,rank_>>
+    std::mdspan<T,Ext,layout_fortran_strided> to_mdspan() const {
+        static_assert(Ext::rank() == rank_, 
+            "Rank of std::mdspan must match the rank of the descriptor");
+        typename layout_fortran_strided::template mapping<Ext> map(get());
+        return {base_addr() - map.offset(), map};
+    }
+
+    template<typename Ext>
+    operator std::mdspan<T,Ext,layout_fortran_strided>() const {
+        return this->to_mdspan<Ext>();
+    }
+
+    // Conversion to std::layout_stride requires positive strides
+    template<typename Ext>
+    operator std::mdspan<T,Ext,std::layout_stride>() const {
+        static_assert(Ext::rank() == rank_, 
+            "Rank of std::mdspan must match the rank of the descriptor");
+        using index_type = typename Ext::index_type;
+        std::array<index_type,rank_> strides;
+        for (int d = 0; d < rank_; ++d) {
+            FCPP_CHECK(sm_[d] > 0);
+            strides[d] = static_cast<index_type>(sm_[d]);
+        }
+        return {base_addr(), std::layout_stride::mapping<Ext>(
+            Fcpp_impl_::make_extents<Ext>(get()), strides)};
+    }
+
+    // Conversion to std::layout_left requires a contiguous array
+    template<typename Ext>
+    operator std::mdspan<T,Ext,std::layout_left>() const {
+        static_assert(Ext::rank() == rank_, 
+            "Rank of std::mdspan must match the rank of the descriptor");
+        return {this->data(), Fcpp_impl_::make_extents<Ext>(get())};
     }
 #endif
 
 private:
 
+    static constexpr bool unit_stride = (layout_ == Fcpp::layout::contiguous);
+
+    // Element strides are cached, so that subscripting does not
+    // need to read the descriptor
+    void update_strides() {
+        // The dimensions of unallocated arrays are undefined
+        if (!ptr_->base_addr) {
+            sm_.fill(1);
+            return;
+        }
+        if constexpr (layout_ == Fcpp::layout::contiguous) {
+            FCPP_CHECK(CFI_is_contiguous(ptr_) > 0);
+        }
+        // The rank may not match if a validation handler returned
+        const int rank = ptr_->rank < rank_ ? ptr_->rank : rank_;
+        sm_.fill(1);
+        for (int d = 0; d < rank; ++d) {
+            FCPP_CHECK(ptr_->dim[d].sm % static_cast<CFI_index_t>(sizeof(T)) == 0);
+            sm_[d] = ptr_->dim[d].sm / static_cast<CFI_index_t>(sizeof(T));
+        }
+    }
+
+    // Stride in units of elements; negative for reversed sections
     template<int d>
-    inline std::size_t stride() const {
+    inline std::ptrdiff_t elem_stride() const {
         static_assert(0 <= d && d < rank_);
-        return ptr_->dim[d].sm;
+        if constexpr (d == 0 && unit_stride) {
+            return 1;
+        } else {
+            return sm_[d];
+        }
     }
 
     using attribute_type = typename std::underlying_type<attr>::type;
@@ -397,6 +1740,258 @@ private:
     }
 
     CFI_cdesc_t *ptr_{nullptr};
+
+    // Element strides, computed once on construction
+    std::array<std::ptrdiff_t,rank_> sm_{};
+};
+
+/**
+ *  Array section (or component) of another array, with its own descriptor
+ *
+ *  The descriptor is established by CFI_section or CFI_select_part, so no
+ *  data is copied. A view can be passed to Fortran like a cdesc, or used
+ *  directly from C++ like a cdesc_ptr.
+ */
+template<typename T, int rank_>
+class cdesc_view {
+public:
+
+    static_assert(rank_ >= 0, "Rank must be non-negative");
+    static_assert(rank_ <= CFI_MAX_RANK, 
+        "The maximum allowed rank is 15");
+    static_assert(Fcpp_impl_::is_supported_type<T>,
+        "The type has no interoperable kind on this platform");
+
+    using value_type = T;
+    using size_type = std::size_t;
+
+    using reference = T&;
+    using const_reference = const T&;
+
+    using pointer = T*;
+    using const_pointer = const T*;
+
+    using iterator = Fcpp_impl_::strided_iterator<T>;
+    using const_iterator = Fcpp_impl_::strided_iterator<const T>;
+
+    constexpr CFI_type_t type() const { return Fcpp_impl_::type<T>(); };
+    constexpr CFI_rank_t rank() const { return rank_; };
+
+    // Section of the array described by source
+    template<typename... Specs>
+    static cdesc_view section_of(const CFI_cdesc_t *source, Specs... specs) {
+        constexpr int n = sizeof...(Specs);
+        static_assert(n > 0, "At least one section specifier is needed");
+        static_assert(Fcpp_impl_::section_rank<Specs...> == rank_,
+            "Rank of the view must match the section specifiers");
+        FCPP_CHECK(source->rank == n);
+
+        CFI_index_t lower[n], upper[n], strides[n];
+        int d = 0;
+        ((Fcpp_impl_::section_bounds(source->dim[d].lower_bound, source->dim[d].extent,
+            specs, lower[d], upper[d], strides[d]), ++d), ...);
+
+        cdesc_view view;
+        view.establish(source);
+        [[maybe_unused]] int status = CFI_section(view.get(),source,lower,upper,strides);
+        FCPP_CHECK(status == CFI_SUCCESS);
+        FCPP_RECORD(section,view.get());
+        view.update_strides();
+        return view;
+    }
+
+    // Assumed-size array described by source, with the last extent 
+    // (-1 in source) set to n
+    static cdesc_view assumed_size(const CFI_cdesc_t *source, CFI_index_t n) {
+        static_assert(rank_ > 0, "Assumed-size arrays have a positive rank");
+        FCPP_CHECK(source->rank == rank_);
+        FCPP_CHECK(Fcpp_impl_::type_matches<T>(source));
+        FCPP_CHECK(source->dim[rank_-1].extent == -1 && n >= 0);
+        cdesc_view view;
+        std::memcpy(&view.desc_,source,sizeof(view.desc_));
+        view.desc_.attribute = CFI_attribute_other;
+        view.desc_.dim[rank_-1].extent = n;
+        view.update_strides();
+        return view;
+    }
+
+    // Component at the given byte displacement of 
+    // the elements of the array described by source
+    static cdesc_view part_of(const CFI_cdesc_t *source, std::size_t displacement) {
+        FCPP_CHECK(source->rank == rank_);
+        cdesc_view view;
+        view.establish(source);
+        [[maybe_unused]] int status = CFI_select_part(view.get(),source,displacement,sizeof(T));
+        FCPP_CHECK(status == CFI_SUCCESS);
+        FCPP_RECORD(section,view.get());
+        view.update_strides();
+        return view;
+    }
+
+    template<typename S>
+    static cdesc_view part_of(const CFI_cdesc_t *source, T S::* member) {
+        FCPP_CHECK(source->elem_len == sizeof(S));
+        FCPP_CHECK(source->base_addr != nullptr);
+        // Offset of the member within the first element
+        const S *s = static_cast<const S*>(source->base_addr);
+        const std::size_t displacement = 
+            reinterpret_cast<const char*>(&(s->*member)) - reinterpret_cast<const char*>(s);
+        return part_of(source,displacement);
+    }
+
+    // Read-only copy of a view of non-const elements
+    template<typename U>
+        requires (std::is_const_v<T> && std::is_same_v<const U,T>)
+    cdesc_view(const cdesc_view<U,rank_>& other) {
+        std::memcpy(&desc_,other.get(),sizeof(desc_));
+        this->update_strides();
+    }
+
+    // Return pointer to the underlying descriptor
+    constexpr auto get() const { return (CFI_cdesc_t *) &desc_; }
+
+    // Implicit cast to C-descriptor pointer
+    operator CFI_cdesc_t* () const { return this->get(); }
+
+    // Evaluate an elementwise expression (Fcpp/expressions.h) into the elements
+    template<Fcpp_impl_::array_expression E>
+    cdesc_view& operator=(const E& e) requires (!std::is_const_v<T>) {
+        e.assign_to(*this);
+        return *this;
+    }
+
+    // Element length in bytes
+    std::size_t elem_len() const { return this->get()->elem_len; }
+
+    inline std::size_t extent(int d) const {
+        FCPP_CHECK_BOUNDS(0 <= d && d < rank_);
+        return this->get()->dim[d].extent;
+    }
+
+    bool is_contiguous() const {
+        FCPP_RECORD(contiguity_check,this->get());
+        return CFI_is_contiguous(this->get()) > 0;
+    }
+
+    // Array subscript operators
+    T& operator[](std::size_t idx) const {
+        static_assert(rank_ == 1,
+            "Rank must be 1 to use array subscript operator");
+        FCPP_CHECK_BOUNDS(Fcpp_impl_::in_bounds(get(),idx));
+        return base_addr()[static_cast<std::ptrdiff_t>(idx)*sm_[0]];
+    }
+
+    // Multidimensional-access operator (zero-based, column-major)
+    template<typename... Idx>
+    T& operator()(Idx... idx) const {
+        FCPP_CHECK_BOUNDS(Fcpp_impl_::in_bounds(get(),idx...));
+        return base_addr()[Fcpp_impl_::linear_offset<false>(sm_, idx...)];
+    }
+
+#if __cpp_multidimensional_subscript >= 202110L
+    template<typename... Idx>
+        requires (sizeof...(Idx) != 1)
+    T& operator[](Idx... idx) const { return this->operator()(idx...); }
+#endif
+
+    // Number of elements
+    size_type size() const {
+        size_type n = 1;
+        for (int d = 0; d < rank_; ++d) {
+            n *= this->extent(d);
+        }
+        return n;
+    }
+    bool empty() const { return this->size() == 0; }
+
+    // Iterator support (rank-1 arrays)
+    iterator begin() const requires (rank_ == 1) { 
+        if (sm_[0] != 1) FCPP_RECORD(strided_iteration,this->get());
+        return iterator(base_addr(), sm_[0]); 
+    }
+    iterator end() const requires (rank_ == 1) { 
+        return iterator(base_addr(), sm_[0]) + extent(0); 
+    }
+    const_iterator cbegin() const requires (rank_ == 1) { return begin(); }
+    const_iterator cend() const requires (rank_ == 1) { return end(); }
+
+    // Section of the view
+    template<typename... Specs>
+    cdesc_view<T,Fcpp_impl_::section_rank<Specs...>> section(Specs... specs) const {
+        static_assert(sizeof...(Specs) == rank_,
+            "Number of section specifiers must be equal to the rank");
+        return cdesc_view<T,Fcpp_impl_::section_rank<Specs...>>::section_of(get(),specs...);
+    }
+
+private:
+
+    cdesc_view() = default;
+
+    // Establish a descriptor which CFI_section or 
+    // CFI_select_part can overwrite
+    void establish(const CFI_cdesc_t *source) {
+        CFI_index_t extents[rank_ > 0 ? rank_ : 1] = {};
+        [[maybe_unused]] int status = CFI_establish(
+            this->get(),
+            source->base_addr,
+            CFI_attribute_other,
+            this->type(),
+            sizeof(T),
+            rank_,
+            extents
+        );
+        FCPP_CHECK(status == CFI_SUCCESS);
+    }
+
+    void update_strides() {
+        for (int d = 0; d < rank_; ++d) {
+            FCPP_CHECK(desc_.dim[d].sm % static_cast<CFI_index_t>(sizeof(T)) == 0);
+            sm_[d] = desc_.dim[d].sm / static_cast<CFI_index_t>(sizeof(T));
+        }
+    }
+
+    constexpr auto base_addr() const {
+        return static_cast<T*>(desc_.base_addr);
+    }
+
+    CFI_CDESC_T(rank_) desc_;
+
+    // Element strides, computed once on construction
+    std::array<std::ptrdiff_t,rank_> sm_{};
 };
 
-} // namespace Fcpp
\ No newline at end of file
+namespace Fcpp_impl_ {
+
+// Rank of the array classes, for generic code taking any of them
+template<typename Array>
+struct array_rank;
+
+template<typename T, int rank_, Fcpp::attr attr_>
+struct array_rank<Fcpp::cdesc<T,rank_,attr_>> : std::integral_constant<int,rank_> {};
+
+template<typename T, int rank_, Fcpp::attr attr_, Fcpp::layout layout_>
+struct array_rank<Fcpp::cdesc_ptr<T,rank_,attr_,layout_>> : std::integral_constant<int,rank_> {};
+
+template<typename T, int rank_>
+struct array_rank<Fcpp::cdesc_view<T,rank_>> : std::integral_constant<int,rank_> {};
+
+} // namespace Fcpp_impl_
+
+} // namespace Fcpp
+
+// The classes only refer to the array elements, so iterators remain valid
+// after the class object is destroyed (except for the owning allocatable
+// cdesc). cdesc_ptr and cdesc_view are also cheap to copy, hence views.
+template<typename T, int rank_, Fcpp::attr attr_>
+inline constexpr bool std::ranges::enable_borrowed_range<Fcpp::cdesc<T,rank_,attr_>> = 
+    (attr_ != Fcpp::attr::allocatable);
+
+template<typename T, int rank_, Fcpp::attr attr_, Fcpp::layout layout_>
+inline constexpr bool std::ranges::enable_borrowed_range<Fcpp::cdesc_ptr<T,rank_,attr_,layout_>> = true;
+template<typename T, int rank_, Fcpp::attr attr_, Fcpp::layout layout_>
+inline constexpr bool std::ranges::enable_view<Fcpp::cdesc_ptr<T,rank_,attr_,layout_>> = true;
+
+template<typename T, int rank_>
+inline constexpr bool std::ranges::enable_borrowed_range<Fcpp::cdesc_view<T,rank_>> = true;
+template<typename T, int rank_>
+inline constexpr bool std::ranges::enable_view<Fcpp::cdesc_view<T,rank_>> = true;
@@ -0,0 +1,533 @@
+#pragma once
+
+// Reductions and elementwise kernels over Fortran arrays
+
+#include <array>
+#include <cmath>
+#include <complex>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "../Fcpp.h"
+
+#ifndef FCPP_SIMD
+#if __has_include(<experimental/simd>)
+#define FCPP_SIMD 1
+#else
+#define FCPP_SIMD 0
+#endif
+#endif
+
+#if FCPP_SIMD
+#include <experimental/simd>
+#endif
+
+namespace Fcpp {
+
+namespace Fcpp_impl_ {
+
+#if FCPP_SIMD
+namespace stdx = std::experimental;
+
+template<typename T>
+using simd_t = stdx::native_simd<T>;
+#endif
+
+// Element types handled by the explicit SIMD path
+template<typename T>
+inline constexpr bool simd_type = FCPP_SIMD &&
+    (std::is_same_v<T,float> || std::is_same_v<T,double> ||
+     (std::is_integral_v<T> && !std::is_same_v<T,bool>));
+
+// Arrays accepted by the kernels (cdesc, cdesc_ptr, cdesc_view)
+template<typename A>
+concept array_operand = requires (const A& a) {
+    typename A::value_type;
+    { a.get() } -> std::convertible_to<const CFI_cdesc_t *>;
+    array_rank<A>::value;
+};
+
+template<typename T>
+struct is_complex : std::false_type {};
+template<typename T>
+struct is_complex<std::complex<T>> : std::true_type {};
+
+// Extents and element strides of K arrays of the same shape, with
+// adjacent dimensions merged where the storage of all of them allows it
+template<int rank_, std::size_t K>
+struct joint_runs {
+    static constexpr int max_rank = rank_ > 0 ? rank_ : 1;
+    int rank = 0;
+    std::array<CFI_index_t,max_rank> extent{};
+    std::array<std::array<CFI_index_t,K>,max_rank> inc{};
+    CFI_index_t size = 1;
+};
+
+template<int rank_, std::size_t K>
+joint_runs<rank_,K> coalesce_joint(const std::array<const CFI_cdesc_t *,K>& desc) {
+    joint_runs<rank_,K> r;
+    for (int d = 0; d < rank_; ++d) {
+        const CFI_index_t n = desc[0]->dim[d].extent;
+        r.size *= n;
+        if (n <= 0) return r;
+
+        std::array<CFI_index_t,K> inc;
+        for (std::size_t a = 0; a < K; ++a) {
+            FCPP_CHECK(desc[a]->dim[d].extent == n);
+            FCPP_CHECK(desc[a]->dim[d].sm % static_cast<CFI_index_t>(desc[a]->elem_len) == 0);
+            inc[a] = desc[a]->dim[d].sm / static_cast<CFI_index_t>(desc[a]->elem_len);
+        }
+        if (n == 1) continue;
+
+        bool merge = r.rank > 0;
+        for (std::size_t a = 0; merge && a < K; ++a) {
+            merge = inc[a] == r.extent[r.rank-1]*r.inc[r.rank-1][a];
+        }
+        if (merge) {
+            r.extent[r.rank-1] *= n;
+        } else {
+            r.extent[r.rank] = n;
+            r.inc[r.rank] = inc;
+            ++r.rank;
+        }
+    }
+    if (r.rank == 0) {
+        // Rank 0, or all extents one
+        r.rank = 1;
+        r.extent[0] = r.size;
+        r.inc[0].fill(1);
+    }
+    return r;
+}
+
+// Call f(offsets, n, incs) for each run of elements, in array element
+// order; offsets are in elements from the base addresses. Stops early
+// when f returns false.
+template<int rank_, std::size_t K, typename F>
+void for_each_run(const std::array<const CFI_cdesc_t *,K>& desc, F&& f) {
+
+    // A null base address (e.g. from an empty std::vector) leaves
+    // the extents unset
+    for (std::size_t a = 0; a < K; ++a) {
+        if (!desc[a]->base_addr) return;
+    }
+
+    const joint_runs<rank_,K> r = coalesce_joint<rank_,K>(desc);
+    if (r.size <= 0) return;
+
+    for (std::size_t a = 0; a < K; ++a) {
+        if (r.rank > 1 || r.inc[0][a] != 1) FCPP_RECORD(strided_iteration,desc[a]);
+    }
+
+    std::array<CFI_index_t,K> off{};
+    if constexpr (rank_ <= 1) {
+        f(off,r.extent[0],r.inc[0]);
+        return;
+    }
+
+    std::array<CFI_index_t,joint_runs<rank_,K>::max_rank> idx{};
+    while (true) {
+        if constexpr (std::is_same_v<decltype(f(off,r.extent[0],r.inc[0])),bool>) {
+            if (!f(off,r.extent[0],r.inc[0])) return;
+        } else {
+            f(off,r.extent[0],r.inc[0]);
+        }
+
+        int d = 1;
+        for (; d < r.rank; ++d) {
+            for (std::size_t a = 0; a < K; ++a) off[a] += r.inc[d][a];
+            if (++idx[d] < r.extent[d]) break;
+            for (std::size_t a = 0; a < K; ++a) off[a] -= r.extent[d]*r.inc[d][a];
+            idx[d] = 0;
+        }
+        if (d >= r.rank) break;
+    }
+}
+
+template<typename T, typename Array>
+T* base(const Array& a) {
+    FCPP_CHECK(a.get()->elem_len == sizeof(T));
+    return static_cast<T *>(a.get()->base_addr);
+}
+
+template<typename Array>
+using element_t = std::remove_cv_t<typename Array::value_type>;
+
+// x*y + z, with a single rounding where the target has FMA instructions
+template<typename V>
+V fmadd(const V& x, const V& y, const V& z) {
+#if FCPP_SIMD && defined(FP_FAST_FMA) && defined(FP_FAST_FMAF)
+    if constexpr (requires { stdx::fma(x,y,z); }) {
+        return stdx::fma(x,y,z);
+    } else if constexpr (std::is_floating_point_v<V>) {
+        return std::fma(x,y,z);
+    } else
+#endif
+    return x*y + z;
+}
+
+// Load W elements starting at element i, contiguous or with a
+// constant stride (gathered lane by lane)
+#if FCPP_SIMD
+template<typename V, bool unit, typename T>
+V load(const T *p, CFI_index_t inc, CFI_index_t i) {
+    if constexpr (unit) {
+        return V(p + i, stdx::element_aligned);
+    } else {
+        return V([p,inc,i](auto lane) {
+            return p[(i + static_cast<CFI_index_t>(lane))*inc];
+        });
+    }
+}
+
+// Fold the leading multiple of 4*W (then W) elements with four
+// independent vector accumulators, advancing i past them
+template<bool unit, typename T, std::size_t K, typename Op, std::size_t... a>
+T fold_simd(const std::array<const T *,K>& p, const std::array<CFI_index_t,K>& inc,
+            CFI_index_t n, CFI_index_t& i, Op& op, std::index_sequence<a...>) {
+    using V = simd_t<T>;
+    constexpr CFI_index_t W = V::size();
+    V acc0(T{}), acc1(T{}), acc2(T{}), acc3(T{});
+    for (; i + 4*W <= n; i += 4*W) {
+        op(acc0, load<V,unit>(p[a],inc[a],i)...);
+        op(acc1, load<V,unit>(p[a],inc[a],i + W)...);
+        op(acc2, load<V,unit>(p[a],inc[a],i + 2*W)...);
+        op(acc3, load<V,unit>(p[a],inc[a],i + 3*W)...);
+    }
+    for (; i + W <= n; i += W) {
+        op(acc0, load<V,unit>(p[a],inc[a],i)...);
+    }
+    return stdx::reduce((acc0 + acc1) + (acc2 + acc3));
+}
+#endif
+
+// Fold op(acc, x[i], y[i], ...) over a run of n elements; op must
+// accept both scalars and (for simd_type elements) simd vectors
+template<typename Acc, typename T, std::size_t K, typename Op>
+Acc fold_run(const std::array<const T *,K>& p, const std::array<CFI_index_t,K>& inc,
+             CFI_index_t n, Op op) {
+    constexpr auto seq = std::make_index_sequence<K>{};
+    CFI_index_t i = 0;
+    Acc total{};
+#if FCPP_SIMD
+    if constexpr (simd_type<T> && std::is_same_v<Acc,T>) {
+        bool unit = true;
+        for (std::size_t a = 0; a < K; ++a) unit = unit && inc[a] == 1;
+        total = unit ? fold_simd<true>(p,inc,n,i,op,seq)
+                     : fold_simd<false>(p,inc,n,i,op,seq);
+    }
+#endif
+    return [&]<std::size_t... a>(std::index_sequence<a...>) {
+        Acc acc0{}, acc1{};
+        for (; i + 2 <= n; i += 2) {
+            op(acc0, p[a][i*inc[a]]...);
+            op(acc1, p[a][(i + 1)*inc[a]]...);
+        }
+        if (i < n) op(acc0, p[a][i*inc[a]]...);
+        return total + (acc0 + acc1);
+    }(seq);
+}
+
+// out[i] = f(x[i], y[i], ...) over a run of n elements, vectorized
+// when all operands have unit stride
+template<typename T, std::size_t K, typename F>
+void map_run(T *out, CFI_index_t inc_out, const std::array<const T *,K>& p,
+             const std::array<CFI_index_t,K>& inc, CFI_index_t n, F f) {
+    [&]<std::size_t... a>(std::index_sequence<a...>) {
+        CFI_index_t i = 0;
+#if FCPP_SIMD
+        if constexpr (simd_type<T>) {
+            using V = simd_t<T>;
+            constexpr CFI_index_t W = V::size();
+            if (inc_out == 1 && ((inc[a] == 1) && ...)) {
+                for (; i + W <= n; i += W) {
+                    V v = f(load<V,true>(p[a],1,i)...);
+                    v.copy_to(out + i, stdx::element_aligned);
+                }
+            }
+        }
+#endif
+        for (; i < n; ++i) {
+            out[i*inc_out] = f(p[a][i*inc[a]]...);
+        }
+    }(std::make_index_sequence<K>{});
+}
+
+// Running minimum and maximum over a run, starting from lo and hi
+template<typename T>
+void minmax_run(const T *p, CFI_index_t inc, CFI_index_t n, T& lo, T& hi) {
+    CFI_index_t i = 0;
+#if FCPP_SIMD
+    if constexpr (simd_type<T>) {
+        using V = simd_t<T>;
+        constexpr CFI_index_t W = V::size();
+        auto body = [&]<bool unit>() {
+            V vlo(lo), vhi(hi);
+            for (; i + W <= n; i += W) {
+                const V v = load<V,unit>(p,inc,i);
+                vlo = stdx::min(vlo,v);
+                vhi = stdx::max(vhi,v);
+            }
+            lo = stdx::hmin(vlo);
+            hi = stdx::hmax(vhi);
+        };
+        if (inc == 1) {
+            body.template operator()<true>();
+        } else {
+            body.template operator()<false>();
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        const T x = p[i*inc];
+        if (x < lo) lo = x;
+        if (hi < x) hi = x;
+    }
+}
+
+// Zero-based position (in array element order) of the first element
+// equal to value, or 0 if there is none
+template<int rank_, typename T>
+std::size_t find_first(const CFI_cdesc_t *desc, T value) {
+    const T *x = static_cast<const T *>(desc->base_addr);
+    std::size_t pos = 0;
+    bool found = false;
+    Fcpp_impl_::for_each_run<rank_,1>({desc}, [&](const auto& off, CFI_index_t n, const auto& inc) {
+        const T *p = x + off[0];
+        for (CFI_index_t i = 0; i < n; ++i) {
+            if (p[i*inc[0]] == value) {
+                pos += i;
+                found = true;
+                return false;
+            }
+        }
+        pos += n;
+        return true;
+    });
+    return found ? pos : 0;
+}
+
+} // namespace Fcpp_impl_
+
+// The kernels below take arrays of any rank (cdesc, cdesc_ptr, cdesc_view
+// or another class with a descriptor); arrays passed together must have
+// the same shape. Runs with unit stride (including a whole contiguous
+// array or a(:,j1:j2)) use explicit SIMD via std::experimental::simd,
+// other runs gather lane by lane or fall back to unrolled scalar loops.
+
+/**
+ *  Sum of the elements, as the Fortran intrinsic sum(a)
+ */
+template<typename Array>
+auto sum(const Array& a) {
+    using T = Fcpp_impl_::element_t<Array>;
+    constexpr int rank_ = Fcpp_impl_::array_rank<Array>::value;
+    const T *x = Fcpp_impl_::base<const T>(a);
+    T s{};
+    Fcpp_impl_::for_each_run<rank_,1>({a.get()}, [&](const auto& off, CFI_index_t n, const auto& inc) {
+        s += Fcpp_impl_::fold_run<T>(std::array<const T *,1>{x + off[0]}, inc, n,
+            [](auto& acc, const auto& xi) { acc += xi; });
+    });
+    return s;
+}
+
+/**
+ *  Dot product, as the Fortran intrinsic dot_product(x,y)
+ *  (for complex elements x is conjugated)
+ */
+template<typename ArrayX, typename ArrayY>
+auto dot(const ArrayX& x, const ArrayY& y) {
+    using T = Fcpp_impl_::element_t<ArrayX>;
+    static_assert(std::is_same_v<T,Fcpp_impl_::element_t<ArrayY>>,
+        "Arrays must have the same element type");
+    constexpr int rank_ = Fcpp_impl_::array_rank<ArrayX>::value;
+    static_assert(rank_ == Fcpp_impl_::array_rank<ArrayY>::value,
+        "Arrays must have the same rank");
+
+    const T *px = Fcpp_impl_::base<const T>(x);
+    const T *py = Fcpp_impl_::base<const T>(y);
+    T s{};
+    Fcpp_impl_::for_each_run<rank_,2>({x.get(),y.get()}, [&](const auto& off, CFI_index_t n, const auto& inc) {
+        s += Fcpp_impl_::fold_run<T>(std::array<const T *,2>{px + off[0], py + off[1]}, inc, n,
+            [](auto& acc, const auto& xi, const auto& yi) {
+                if constexpr (Fcpp_impl_::is_complex<T>::value) {
+                    acc += std::conj(xi)*yi;
+                } else {
+                    acc = Fcpp_impl_::fmadd(xi,yi,acc);
+                }
+            });
+    });
+    return s;
+}
+
+/**
+ *  Euclidean norm, as the Fortran intrinsic norm2(x)
+ *
+ *  The sum of squares is accumulated directly; only if it overflows
+ *  or underflows is the array traversed again with scaling.
+ */
+template<typename Array>
+auto nrm2(const Array& a) {
+    using T = Fcpp_impl_::element_t<Array>;
+    using R = decltype(std::abs(T{}));
+    static_assert(std::is_floating_point_v<R>,
+        "nrm2 requires real or complex elements");
+    constexpr int rank_ = Fcpp_impl_::array_rank<Array>::value;
+    const T *x = Fcpp_impl_::base<const T>(a);
+
+    R ss{};
+    Fcpp_impl_::for_each_run<rank_,1>({a.get()}, [&](const auto& off, CFI_index_t n, const auto& inc) {
+        ss += Fcpp_impl_::fold_run<R>(std::array<const T *,1>{x + off[0]}, inc, n,
+            [](auto& acc, const auto& xi) {
+                if constexpr (Fcpp_impl_::is_complex<T>::value) {
+                    acc += std::norm(xi);
+                } else {
+                    acc = Fcpp_impl_::fmadd(xi,xi,acc);
+                }
+            });
+    });
+    if (std::isfinite(ss) && ss >= std::numeric_limits<R>::min()) {
+        return std::sqrt(ss);
+    }
+    // Slow path: scale by the largest magnitude
+    R amax{};
+    Fcpp_impl_::for_each_run<rank_,1>({a.get()}, [&](const auto& off, CFI_index_t n, const auto& inc) {
+        for (CFI_index_t i = 0; i < n; ++i) {
+            amax = std::fmax(amax, std::abs(x[off[0] + i*inc[0]]));
+        }
+    });
+    if (amax == R{0} || !std::isfinite(amax)) return amax;
+    ss = R{0};
+    Fcpp_impl_::for_each_run<rank_,1>({a.get()}, [&](const auto& off, CFI_index_t n, const auto& inc) {
+        for (CFI_index_t i = 0; i < n; ++i) {
+            const R t = std::abs(x[off[0] + i*inc[0]]) / amax;
+            ss += t*t;
+        }
+    });
+    return amax*std::sqrt(ss);
+}
+
+/**
+ *  y = alpha*x + y (BLAS axpy)
+ */
+template<typename ArrayX, typename ArrayY>
+void axpy(Fcpp_impl_::element_t<ArrayY> alpha, const ArrayX& x, const ArrayY& y) {
+    using T = Fcpp_impl_::element_t<ArrayY>;
+    static_assert(!std::is_const_v<typename ArrayY::value_type>,
+        "The array y is modified");
+    static_assert(std::is_same_v<T,Fcpp_impl_::element_t<ArrayX>>,
+        "Arrays must have the same element type");
+    constexpr int rank_ = Fcpp_impl_::array_rank<ArrayY>::value;
+    static_assert(rank_ == Fcpp_impl_::array_rank<ArrayX>::value,
+        "Arrays must have the same rank");
+
+    const T *px = Fcpp_impl_::base<const T>(x);
+    T *py = Fcpp_impl_::base<T>(y);
+    Fcpp_impl_::for_each_run<rank_,2>({x.get(),y.get()}, [&](const auto& off, CFI_index_t n, const auto& inc) {
+        Fcpp_impl_::map_run(py + off[1], inc[1],
+            std::array<const T *,2>{px + off[0], py + off[1]}, inc, n,
+            [alpha](const auto& xi, const auto& yi) {
+                using V = std::remove_cvref_t<decltype(xi)>;
+                return Fcpp_impl_::fmadd(V(alpha),xi,yi);
+            });
+    });
+}
+
+/**
+ *  x = alpha*x (BLAS scal)
+ */
+template<typename Array>
+void scale(Fcpp_impl_::element_t<Array> alpha, const Array& x) {
+    using T = Fcpp_impl_::element_t<Array>;
+    static_assert(!std::is_const_v<typename Array::value_type>,
+        "The array is modified");
+    constexpr int rank_ = Fcpp_impl_::array_rank<Array>::value;
+
+    T *px = Fcpp_impl_::base<T>(x);
+    Fcpp_impl_::for_each_run<rank_,1>({x.get()}, [&](const auto& off, CFI_index_t n, const auto& inc) {
+        Fcpp_impl_::map_run(px + off[0], inc[0], std::array<const T *,1>{px + off[0]}, inc, n,
+            [alpha](const auto& xi) { return alpha*xi; });
+    });
+}
+
+/**
+ *  out = x*y + z, elementwise (fused multiply-add where the target
+ *  supports it); out may be one of the operands
+ */
+template<typename ArrayX, typename ArrayY, typename ArrayZ, typename ArrayOut>
+void fma(const ArrayX& x, const ArrayY& y, const ArrayZ& z, const ArrayOut& out) {
+    using T = Fcpp_impl_::element_t<ArrayOut>;
+    static_assert(!std::is_const_v<typename ArrayOut::value_type>,
+        "The array out is modified");
+    static_assert(std::is_same_v<T,Fcpp_impl_::element_t<ArrayX>> &&
+                  std::is_same_v<T,Fcpp_impl_::element_t<ArrayY>> &&
+                  std::is_same_v<T,Fcpp_impl_::element_t<ArrayZ>>,
+        "Arrays must have the same element type");
+    constexpr int rank_ = Fcpp_impl_::array_rank<ArrayOut>::value;
+    static_assert(rank_ == Fcpp_impl_::array_rank<ArrayX>::value &&
+                  rank_ == Fcpp_impl_::array_rank<ArrayY>::value &&
+                  rank_ == Fcpp_impl_::array_rank<ArrayZ>::value,
+        "Arrays must have the same rank");
+
+    const T *px = Fcpp_impl_::base<const T>(x);
+    const T *py = Fcpp_impl_::base<const T>(y);
+    const T *pz = Fcpp_impl_::base<const T>(z);
+    T *po = Fcpp_impl_::base<T>(out);
+    Fcpp_impl_::for_each_run<rank_,4>({x.get(),y.get(),z.get(),out.get()},
+        [&](const auto& off, CFI_index_t n, const auto& inc) {
+            Fcpp_impl_::map_run(po + off[3], inc[3],
+                std::array<const T *,3>{px + off[0], py + off[1], pz + off[2]},
+                std::array<CFI_index_t,3>{inc[0], inc[1], inc[2]}, n,
+                [](const auto& xi, const auto& yi, const auto& zi) {
+                    return Fcpp_impl_::fmadd(xi,yi,zi);
+                });
+        });
+}
+
+/**
+ *  Smallest and largest element, as std::pair{minval(a), maxval(a)};
+ *  the array must not be empty
+ */
+template<typename Array>
+auto minmax(const Array& a) {
+    using T = Fcpp_impl_::element_t<Array>;
+    constexpr int rank_ = Fcpp_impl_::array_rank<Array>::value;
+    const T *x = Fcpp_impl_::base<const T>(a);
+
+    bool first = true;
+    std::pair<T,T> r{};
+    Fcpp_impl_::for_each_run<rank_,1>({a.get()}, [&](const auto& off, CFI_index_t n, const auto& inc) {
+        if (first) {
+            r.first = r.second = x[off[0]];
+            first = false;
+        }
+        Fcpp_impl_::minmax_run(x + off[0], inc[0], n, r.first, r.second);
+    });
+    FCPP_CHECK(!first);
+    return r;
+}
+
+/**
+ *  Zero-based position, in array element order, of the first smallest
+ *  element (minloc(a) - 1 for rank 1); the array must not be empty
+ */
+template<typename Array>
+std::size_t argmin(const Array& a) {
+    constexpr int rank_ = Fcpp_impl_::array_rank<Array>::value;
+    return Fcpp_impl_::find_first<rank_>(a.get(), minmax(a).first);
+}
+
+/**
+ *  Zero-based position, in array element order, of the first largest
+ *  element (maxloc(a) - 1 for rank 1); the array must not be empty
+ */
+template<typename Array>
+std::size_t argmax(const Array& a) {
+    constexpr int rank_ = Fcpp_impl_::array_rank<Array>::value;
+    return Fcpp_impl_::find_first<rank_>(a.get(), minmax(a).second);
+}
+
+} // namespace Fcpp
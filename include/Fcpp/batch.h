@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstddef>
+#include <ranges>
+#include <vector>
+
+#include "../Fcpp.h"
+
+namespace Fcpp {
+
+/**
+ *  Descriptors of many arrays with the same type and rank, e.g. one per
+ *  cell of a mesh, stored in one contiguous block
+ *
+ *  Only the first descriptor is established with CFI_establish; the 
+ *  others are copies of it with the base address and extents filled in
+ *  (as in cdesc::rebind), so building a batch is a single pass over 
+ *  contiguous memory.
+ *
+ *  On the Fortran side a batch can be received as an array of 
+ *  type(c_ptr), either the descriptors themselves (descriptors()) or 
+ *  the base addresses together with the extents (addresses() and 
+ *  extents()), for use with c_f_pointer in a loop.
+ */
+template<typename T, int rank_ = 1>
+class cdesc_batch {
+public:
+
+    static_assert(rank_ >= 1, "Rank must be positive");
+    static_assert(rank_ <= CFI_MAX_RANK, 
+        "The maximum allowed rank is 15");
+    static_assert(Fcpp_impl_::is_supported_type<T>,
+        "The type has no interoperable kind on this platform");
+
+    using value_type = T;
+    using size_type = std::size_t;
+
+    constexpr CFI_type_t type() const { return Fcpp_impl_::type<T>(); };
+    constexpr CFI_rank_t rank() const { return rank_; };
+
+    cdesc_batch() {
+        CFI_index_t extents[rank_] = {};
+        [[maybe_unused]] int status = CFI_establish(
+            (CFI_cdesc_t *) &prototype_.desc, Fcpp_impl_::empty_base_addr(), CFI_attribute_other, 
+            this->type(), sizeof(T), rank_, extents);
+        FCPP_CHECK(status == CFI_SUCCESS);
+    }
+
+    // Construct from a range of contiguous containers (rank 1)
+    template<std::ranges::input_range R>
+        requires (rank_ == 1 && 
+                  std::ranges::contiguous_range<std::ranges::range_reference_t<R>>)
+    explicit cdesc_batch(R&& containers) : cdesc_batch() {
+        this->assign(containers);
+    }
+
+    // Copying would leave the descriptor pointers of the copy dangling
+    cdesc_batch(const cdesc_batch&) = delete;
+    cdesc_batch& operator=(const cdesc_batch&) = delete;
+    cdesc_batch(cdesc_batch&&) = default;
+    cdesc_batch& operator=(cdesc_batch&&) = default;
+
+    // Replace the contents, reusing the storage
+    template<std::ranges::input_range R>
+        requires (rank_ == 1 && 
+                  std::ranges::contiguous_range<std::ranges::range_reference_t<R>>)
+    void assign(R&& containers) {
+        this->clear();
+        if constexpr (std::ranges::sized_range<R>) {
+            this->reserve(std::ranges::size(containers));
+        }
+        for (auto&& c : containers) {
+            this->push_back(std::ranges::data(c),std::ranges::size(c));
+        }
+    }
+
+    template<typename... Exts>
+    void push_back(T* ptr, Exts... exts) {
+        static_assert(sizeof...(Exts) == rank_,
+            "Number of extents must be equal to the rank");
+        const CFI_index_t extents[rank_] = { static_cast<CFI_index_t>(exts)... };
+
+        // Growing the storage moves all descriptors
+        const storage *old = descs_.data();
+        descs_.push_back(prototype_);
+        if (descs_.data() != old) {
+            ptrs_.clear();
+            for (auto& s : descs_) ptrs_.push_back((CFI_cdesc_t *) &s.desc);
+        } else {
+            ptrs_.push_back((CFI_cdesc_t *) &descs_.back().desc);
+        }
+
+        auto& desc = descs_.back().desc;
+        desc.base_addr = ptr ? static_cast<void *>(ptr) : Fcpp_impl_::empty_base_addr();
+        addrs_.push_back(desc.base_addr);
+
+        CFI_index_t sm = sizeof(T);
+        for (int d = 0; d < rank_; ++d) {
+            FCPP_CHECK(extents[d] >= 0);
+            desc.dim[d].lower_bound = 0;
+            desc.dim[d].extent = extents[d];
+            desc.dim[d].sm = sm;
+            sm *= extents[d];
+            exts_.push_back(extents[d]);
+        }
+    }
+
+    void reserve(size_type n) {
+        descs_.reserve(n);
+        ptrs_.reserve(n);
+        addrs_.reserve(n);
+        exts_.reserve(n*rank_);
+    }
+
+    void clear() {
+        descs_.clear();
+        ptrs_.clear();
+        addrs_.clear();
+        exts_.clear();
+    }
+
+    size_type size() const { return descs_.size(); }
+    bool empty() const { return descs_.empty(); }
+
+    // Descriptor of the i-th array
+    CFI_cdesc_t* operator[](size_type i) const {
+        FCPP_CHECK_BOUNDS(i < size());
+        return ptrs_[i];
+    }
+
+    // Table of descriptor pointers
+    CFI_cdesc_t* const* data() const { return ptrs_.data(); }
+
+    // The descriptor pointers as a rank-1 array of type(c_ptr)
+    cdesc<CFI_cdesc_t*> descriptors() { return view_of(ptrs_); }
+
+    // Base addresses, as a rank-1 array of type(c_ptr)
+    cdesc<void*> addresses() { return view_of(addrs_); }
+
+    // Extents, as an integer(c_ptrdiff_t) array of shape [rank, size]
+    cdesc<CFI_index_t,2> extents() {
+        return cdesc<CFI_index_t,2>(
+            exts_.empty() ? static_cast<CFI_index_t *>(Fcpp_impl_::empty_base_addr()) : exts_.data(),
+            rank_, static_cast<int>(this->size()));
+    }
+
+private:
+
+    // CFI_CDESC_T declares an unnamed struct, so it is wrapped to be
+    // stored in a vector
+    struct storage { CFI_CDESC_T(rank_) desc; };
+
+    template<typename U>
+    static cdesc<U> view_of(std::vector<U>& v) {
+        return cdesc<U>(v.empty() ? static_cast<U *>(Fcpp_impl_::empty_base_addr()) : v.data(),
+            static_cast<int>(v.size()));
+    }
+
+    storage prototype_;
+    std::vector<storage> descs_;
+    std::vector<CFI_cdesc_t*> ptrs_;
+    std::vector<void*> addrs_;
+    std::vector<CFI_index_t> exts_;
+};
+
+} // namespace Fcpp
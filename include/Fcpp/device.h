@@ -0,0 +1,475 @@
+#pragma once
+
+// Descriptors of arrays in device (accelerator) memory, and copies
+// between host and device
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#ifndef FCPP_USE_CUDA
+#define FCPP_USE_CUDA 0
+#endif
+
+#if FCPP_USE_CUDA
+#include <cuda_runtime.h>
+#endif
+
+#include "../Fcpp.h"
+#include "pack.h"
+
+namespace Fcpp {
+
+/**
+ *  Memory spaces: where the elements of a cdesc_device live, and how to
+ *  allocate them and copy them from and to host memory
+ */
+template<typename S>
+concept memory_space = std::equality_comparable<S> &&
+    requires (const S& s, void *p, const void *q, std::size_t n) {
+        { s.allocate(n) } -> std::same_as<void *>;
+        s.deallocate(p);
+        s.copy_to_device(p, q, n);
+        s.copy_to_host(p, q, n);
+    };
+
+#if defined(_OPENMP)
+/**
+ *  Memory of an OpenMP target device. Without offload devices the
+ *  default device is the host itself, and this is ordinary memory.
+ */
+struct omp_device_space {
+    int device = omp_get_default_device();
+
+    void *allocate(std::size_t bytes) const {
+        if (bytes == 0) return nullptr;
+        void *p = omp_target_alloc(bytes, device);
+        if (!p) throw std::bad_alloc();
+        return p;
+    }
+
+    void deallocate(void *p) const {
+        if (p) omp_target_free(p, device);
+    }
+
+    void copy_to_device(void *dst, const void *src, std::size_t bytes) const {
+        copy(dst, src, bytes, device, omp_get_initial_device());
+    }
+
+    void copy_to_host(void *dst, const void *src, std::size_t bytes) const {
+        copy(dst, src, bytes, omp_get_initial_device(), device);
+    }
+
+    friend bool operator==(const omp_device_space&, const omp_device_space&) = default;
+
+private:
+    static void copy(void *dst, const void *src, std::size_t bytes, int to, int from) {
+        if (bytes == 0) return;
+        if (omp_target_memcpy(dst, const_cast<void *>(src), bytes, 0, 0, to, from) != 0) {
+            throw std::runtime_error("omp_target_memcpy failed");
+        }
+    }
+};
+#endif
+
+#if FCPP_USE_CUDA
+/**
+ *  Device memory of the current CUDA device (cudaMalloc)
+ */
+struct cuda_space {
+
+    void *allocate(std::size_t bytes) const {
+        if (bytes == 0) return nullptr;
+        void *p = nullptr;
+        if (cudaMalloc(&p, bytes) != cudaSuccess) throw std::bad_alloc();
+        return p;
+    }
+
+    void deallocate(void *p) const {
+        if (p) cudaFree(p);
+    }
+
+    void copy_to_device(void *dst, const void *src, std::size_t bytes) const {
+        check(cudaMemcpy(dst, src, bytes, cudaMemcpyHostToDevice));
+    }
+
+    void copy_to_host(void *dst, const void *src, std::size_t bytes) const {
+        check(cudaMemcpy(dst, src, bytes, cudaMemcpyDeviceToHost));
+    }
+
+    friend bool operator==(const cuda_space&, const cuda_space&) = default;
+
+private:
+    static void check(cudaError_t status) {
+        if (status != cudaSuccess) throw std::runtime_error(cudaGetErrorString(status));
+    }
+};
+#endif
+
+/**
+ *  Descriptor of an array whose elements are in the memory space Space,
+ *  e.g. to pass device arrays to Fortran kernels offloaded with
+ *  !$omp target ... has_device_addr(a)
+ *
+ *  The elements are not accessible from the host, so there is no element
+ *  access or iteration; use copy() and copy_async(). The array either
+ *  owns contiguous storage allocated in Space, or describes device
+ *  memory owned elsewhere (see device_view and mapped_on_device).
+ */
+template<typename T, int rank_, memory_space Space>
+class cdesc_device {
+public:
+
+    static_assert(rank_ >= 0, "Rank must be non-negative");
+    static_assert(rank_ <= CFI_MAX_RANK,
+        "The maximum allowed rank is 15");
+    static_assert(std::is_trivially_copyable_v<T>,
+        "Elements of a device array must be trivially copyable");
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using space_type = Space;
+
+    constexpr CFI_type_t type() const { return Fcpp_impl_::type<T>(); };
+    constexpr CFI_rank_t rank() const { return rank_; };
+
+    // Allocate contiguous storage for an array of the given extents
+    template<typename... Exts>
+        requires (sizeof...(Exts) == rank_ && (std::is_integral_v<Exts> && ...))
+    explicit cdesc_device(Space space, Exts... exts) : space_(std::move(space)), owns_(true) {
+        CFI_index_t extents[rank_ > 0 ? rank_ : 1] = { static_cast<CFI_index_t>(exts)... };
+        std::size_t n = 1;
+        for (int d = 0; d < rank_; ++d) {
+            FCPP_CHECK(extents[d] >= 0);
+            n *= static_cast<std::size_t>(extents[d]);
+        }
+        void *p = space_.allocate(n*sizeof(T));
+        this->establish(p ? p : Fcpp_impl_::empty_base_addr(), extents);
+    }
+
+    // Describe device memory at ptr, laid out like the array described
+    // by layout (same extents and memory strides); the memory is not owned
+    static cdesc_device device_view(Space space, T *ptr, const CFI_cdesc_t *layout) {
+        FCPP_CHECK(layout->rank == rank_);
+        FCPP_CHECK(layout->elem_len == sizeof(T));
+        cdesc_device a(std::move(space), view_tag{});
+        std::memcpy(&a.desc_, layout, sizeof(a.desc_));
+        a.desc_.base_addr = ptr;
+        a.desc_.attribute = CFI_attribute_other;
+        return a;
+    }
+
+    cdesc_device(const cdesc_device&) = delete;
+    cdesc_device& operator=(const cdesc_device&) = delete;
+
+    cdesc_device(cdesc_device&& other) noexcept
+        : space_(other.space_), owns_(std::exchange(other.owns_,false)), desc_(other.desc_) {}
+
+    cdesc_device& operator=(cdesc_device&& other) noexcept {
+        if (this != &other) {
+            this->release();
+            space_ = other.space_;
+            owns_ = std::exchange(other.owns_,false);
+            desc_ = other.desc_;
+        }
+        return *this;
+    }
+
+    ~cdesc_device() { this->release(); }
+
+    // Return pointer to the underlying descriptor
+    constexpr auto get() const { return (CFI_cdesc_t *) &desc_; }
+
+    // Implicit cast to C-descriptor pointer
+    operator CFI_cdesc_t* () const { return this->get(); }
+
+    const Space& space() const { return space_; }
+
+    // Whether the storage is owned (allocated by the constructor)
+    bool owns_storage() const { return owns_; }
+
+    inline std::size_t extent(int d) const {
+        FCPP_CHECK_BOUNDS(0 <= d && d < rank_);
+        return this->get()->dim[d].extent;
+    }
+
+    size_type size() const {
+        size_type n = 1;
+        for (int d = 0; d < rank_; ++d) {
+            n *= this->extent(d);
+        }
+        return n;
+    }
+
+    bool is_contiguous() const { return CFI_is_contiguous(this->get()) > 0; }
+
+    // Device address of the first element
+    T* data() const { return static_cast<T*>(this->get()->base_addr); }
+
+private:
+
+    struct view_tag {};
+    cdesc_device(Space space, view_tag) : space_(std::move(space)), owns_(false) {}
+
+    void establish(void *ptr, const CFI_index_t extents[]) {
+        [[maybe_unused]] int status = CFI_establish(this->get(), ptr,
+            CFI_attribute_other, this->type(), sizeof(T), rank_, extents);
+        FCPP_CHECK(status == CFI_SUCCESS);
+        FCPP_RECORD(establish,this->get());
+    }
+
+    void release() {
+        if (owns_ && this->size() > 0) space_.deallocate(desc_.base_addr);
+        owns_ = false;
+    }
+
+    Space space_;
+    bool owns_;
+    CFI_CDESC_T(rank_) desc_;
+};
+
+namespace Fcpp_impl_ {
+
+template<typename T, int rank_, typename Space>
+struct array_rank<Fcpp::cdesc_device<T,rank_,Space>> : std::integral_constant<int,rank_> {};
+
+template<typename Array>
+std::size_t array_bytes(const Array& a) {
+    return a.size()*sizeof(typename Array::value_type);
+}
+
+template<typename Device, typename Host>
+void check_copy([[maybe_unused]] const Device& dev, [[maybe_unused]] const Host& host) {
+    static_assert(std::is_same_v<typename Device::value_type,
+                                 std::remove_cv_t<typename Host::value_type>>,
+        "Host and device arrays must have the same element type");
+    static_assert(array_rank<Device>::value == array_rank<Host>::value,
+        "Host and device arrays must have the same rank");
+    for (int d = 0; d < array_rank<Device>::value; ++d) {
+        FCPP_CHECK(dev.extent(d) == host.extent(d));
+    }
+    // The device side is moved as one block
+    FCPP_CHECK(dev.is_contiguous());
+}
+
+} // namespace Fcpp_impl_
+
+/**
+ *  Copy a host array (cdesc, cdesc_ptr, cdesc_view) to a contiguous
+ *  device array of the same shape; a strided host array is packed
+ *  into a staging buffer first
+ */
+template<typename T, int rank_, typename Space, typename Host>
+void copy(const cdesc_device<T,rank_,Space>& dst, const Host& src) {
+    Fcpp_impl_::check_copy(dst, src);
+    if (dst.size() == 0) return;
+    if (CFI_is_contiguous(src.get()) > 0) {
+        dst.space().copy_to_device(dst.data(), src.get()->base_addr, Fcpp_impl_::array_bytes(dst));
+    } else {
+        std::vector<T> staging(dst.size());
+        pack(src, staging.data());
+        dst.space().copy_to_device(dst.data(), staging.data(), Fcpp_impl_::array_bytes(dst));
+    }
+}
+
+/**
+ *  Copy a contiguous device array to a host array of the same shape
+ */
+template<typename Host, typename T, int rank_, typename Space>
+void copy(const Host& dst, const cdesc_device<T,rank_,Space>& src) {
+    static_assert(!std::is_const_v<typename Host::value_type>,
+        "The host array is modified");
+    Fcpp_impl_::check_copy(src, dst);
+    if (src.size() == 0) return;
+    if (CFI_is_contiguous(dst.get()) > 0) {
+        src.space().copy_to_host(dst.get()->base_addr, src.data(), Fcpp_impl_::array_bytes(src));
+    } else {
+        std::vector<T> staging(src.size());
+        src.space().copy_to_host(staging.data(), src.data(), Fcpp_impl_::array_bytes(src));
+        unpack(staging.data(), dst);
+    }
+}
+
+/**
+ *  In-order queue of transfers, run by a thread of its own so that the
+ *  caller can compute while copies are in flight (the analogue of a
+ *  CUDA stream for the memory spaces of this header)
+ */
+class device_stream {
+public:
+
+    device_stream() : worker_([this] { this->run(); }) {}
+
+    device_stream(const device_stream&) = delete;
+    device_stream& operator=(const device_stream&) = delete;
+
+    ~device_stream() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        ready_.notify_one();
+        worker_.join();
+    }
+
+    // Append a task, run after all the ones enqueued before it
+    void enqueue(std::function<void()> task) {
+        {
+            std::lock_guard lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        ready_.notify_one();
+    }
+
+    // Wait for the enqueued tasks; rethrows the first exception raised
+    // by one of them (the following ones are still run)
+    void synchronize() {
+        std::unique_lock lock(mutex_);
+        idle_.wait(lock, [this] { return tasks_.empty() && !busy_; });
+        if (error_) std::rethrow_exception(std::exchange(error_,nullptr));
+    }
+
+private:
+
+    void run() {
+        std::unique_lock lock(mutex_);
+        for (;;) {
+            ready_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+            if (tasks_.empty()) return;
+            std::function<void()> task = std::move(tasks_.front());
+            tasks_.pop_front();
+            busy_ = true;
+            lock.unlock();
+            try {
+                task();
+            } catch (...) {
+                std::lock_guard guard(mutex_);
+                if (!error_) error_ = std::current_exception();
+            }
+            lock.lock();
+            busy_ = false;
+            if (tasks_.empty()) idle_.notify_all();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable ready_, idle_;
+    std::deque<std::function<void()>> tasks_;
+    std::exception_ptr error_;
+    bool busy_{false};
+    bool stop_{false};
+    std::thread worker_;
+};
+
+/**
+ *  Asynchronous copy from host to device on a stream. A strided host
+ *  array is packed before returning; a contiguous one must not be
+ *  modified, and both arrays must stay allocated, until the stream is
+ *  synchronized.
+ */
+template<typename T, int rank_, typename Space, typename Host>
+void copy_async(const cdesc_device<T,rank_,Space>& dst, const Host& src, device_stream& stream) {
+    Fcpp_impl_::check_copy(dst, src);
+    if (dst.size() == 0) return;
+    const std::size_t bytes = Fcpp_impl_::array_bytes(dst);
+    void *to = dst.data();
+    if (CFI_is_contiguous(src.get()) > 0) {
+        const void *from = src.get()->base_addr;
+        stream.enqueue([space = dst.space(), to, from, bytes] {
+            space.copy_to_device(to, from, bytes);
+        });
+    } else {
+        std::vector<T> staging(dst.size());
+        pack(src, staging.data());
+        stream.enqueue([space = dst.space(), to, staging = std::move(staging), bytes] {
+            space.copy_to_device(to, staging.data(), bytes);
+        });
+    }
+}
+
+/**
+ *  Asynchronous copy from device to host on a stream; the elements of
+ *  dst are only valid after the stream is synchronized
+ */
+template<typename Host, typename T, int rank_, typename Space>
+void copy_async(const Host& dst, const cdesc_device<T,rank_,Space>& src, device_stream& stream) {
+    static_assert(!std::is_const_v<typename Host::value_type>,
+        "The host array is modified");
+    Fcpp_impl_::check_copy(src, dst);
+    if (src.size() == 0) return;
+    const std::size_t bytes = Fcpp_impl_::array_bytes(src);
+    const void *from = src.data();
+    if (CFI_is_contiguous(dst.get()) > 0) {
+        void *to = dst.get()->base_addr;
+        stream.enqueue([space = src.space(), to, from, bytes] {
+            space.copy_to_host(to, from, bytes);
+        });
+    } else if constexpr (rank_ > 0) {
+        // The host descriptor is copied along, as dst may be a temporary
+        auto view = [&]<std::size_t... d>(std::index_sequence<d...>) {
+            return cdesc_view<T,rank_>::section_of(dst.get(), ((void) d, full_extent)...);
+        }(std::make_index_sequence<rank_>{});
+        stream.enqueue([space = src.space(), view, from, bytes, n = src.size()] {
+            std::vector<T> staging(n);
+            space.copy_to_host(staging.data(), from, bytes);
+            unpack(staging.data(), view);
+        });
+    }
+}
+
+#if defined(_OPENMP)
+/**
+ *  Device descriptor of a host array mapped to an OpenMP device, e.g.
+ *  a Fortran array inside !$omp target data map(a); the extents and
+ *  strides are those of the host array, the address is the device one
+ *
+ *  The whole array must be mapped; the result is valid while it is.
+ */
+template<typename Array>
+auto mapped_on_device(const Array& a, int device = omp_get_default_device()) {
+
+    using T = std::remove_cv_t<typename Array::value_type>;
+    constexpr int rank_ = Fcpp_impl_::array_rank<Array>::value;
+    const CFI_cdesc_t *desc = a.get();
+
+    void *host = desc->base_addr;
+    if (a.size() > 0) {
+        // Lowest and highest addressed elements
+        const char *lo = static_cast<const char *>(host), *hi = lo;
+        for (int d = 0; d < rank_; ++d) {
+            const CFI_index_t span = (desc->dim[d].extent - 1)*desc->dim[d].sm;
+            (span < 0 ? lo : hi) += span;
+        }
+        FCPP_CHECK(omp_target_is_present(lo, device) && omp_target_is_present(hi, device));
+    }
+
+    // Translated like a pointer into a mapped object
+    void *dev = host;
+    if (a.size() > 0) {
+        void *ptr = host;
+#pragma omp target data use_device_ptr(ptr) device(device)
+        {
+            dev = ptr;
+        }
+    }
+    return cdesc_device<T,rank_,omp_device_space>::device_view(
+        omp_device_space{device}, static_cast<T *>(dev), desc);
+}
+#endif
+
+} // namespace Fcpp
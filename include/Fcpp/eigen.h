@@ -0,0 +1,83 @@
+#pragma once
+
+// Zero-copy views of Fortran arrays as Eigen matrices and vectors
+//
+// The other direction needs no header: cdesc can be constructed from
+// any Eigen object with unit inner stride (e.g. a Map or a Block).
+
+#include <type_traits>
+
+#include <Eigen/Core>
+
+#include "../Fcpp.h"
+
+namespace Fcpp {
+
+namespace Fcpp_impl_ {
+
+template<typename T>
+using eigen_matrix_t = std::conditional_t<std::is_const_v<T>,
+    const Eigen::Matrix<std::remove_const_t<T>,Eigen::Dynamic,Eigen::Dynamic>,
+    Eigen::Matrix<std::remove_const_t<T>,Eigen::Dynamic,Eigen::Dynamic>>;
+
+template<typename T>
+using eigen_vector_t = std::conditional_t<std::is_const_v<T>,
+    const Eigen::Matrix<std::remove_const_t<T>,Eigen::Dynamic,1>,
+    Eigen::Matrix<std::remove_const_t<T>,Eigen::Dynamic,1>>;
+
+// Element stride of dimension d; Eigen expects non-negative strides
+template<typename T>
+Eigen::Index eigen_stride(const CFI_cdesc_t *desc, int d) {
+    const CFI_index_t sm = desc->dim[d].sm;
+    FCPP_CHECK(sm >= 0 && sm % static_cast<CFI_index_t>(sizeof(T)) == 0);
+    return static_cast<Eigen::Index>(sm / static_cast<CFI_index_t>(sizeof(T)));
+}
+
+} // namespace Fcpp_impl_
+
+template<typename T>
+using eigen_map = Eigen::Map<Fcpp_impl_::eigen_matrix_t<T>,
+    Eigen::Unaligned,Eigen::Stride<Eigen::Dynamic,Eigen::Dynamic>>;
+
+template<typename T>
+using eigen_vector_map = Eigen::Map<Fcpp_impl_::eigen_vector_t<T>,
+    Eigen::Unaligned,Eigen::InnerStride<Eigen::Dynamic>>;
+
+/**
+ *  View of a rank-2 array (or section) as an Eigen matrix, or of a
+ *  rank-1 array as a column vector, following its memory strides
+ *
+ *  The map refers to the array elements, e.g. to_eigen(a) *= 2 scales
+ *  a in place. Sections with negative strides are not supported.
+ */
+template<typename Array>
+    requires requires (const Array& a) {
+        typename Array::value_type;
+        { a.get() } -> std::convertible_to<const CFI_cdesc_t *>;
+        Fcpp_impl_::array_rank<Array>::value;
+    }
+auto to_eigen(const Array& a) {
+
+    using T = typename Array::value_type;
+    constexpr int rank_ = Fcpp_impl_::array_rank<Array>::value;
+    static_assert(rank_ == 1 || rank_ == 2,
+        "Only arrays of rank 1 or 2 can be viewed as Eigen objects");
+
+    const CFI_cdesc_t *desc = a.get();
+    FCPP_CHECK(desc->elem_len == sizeof(T));
+    T *ptr = static_cast<T *>(desc->base_addr);
+
+    if constexpr (rank_ == 1) {
+        if (!ptr) return eigen_vector_map<T>(nullptr,0,Eigen::InnerStride<>(1));
+        return eigen_vector_map<T>(ptr,desc->dim[0].extent,
+            Eigen::InnerStride<>(Fcpp_impl_::eigen_stride<T>(desc,0)));
+    } else {
+        using stride_type = Eigen::Stride<Eigen::Dynamic,Eigen::Dynamic>;
+        if (!ptr) return eigen_map<T>(nullptr,0,0,stride_type(0,1));
+        return eigen_map<T>(ptr,desc->dim[0].extent,desc->dim[1].extent,
+            stride_type(Fcpp_impl_::eigen_stride<T>(desc,1),
+                        Fcpp_impl_::eigen_stride<T>(desc,0)));
+    }
+}
+
+} // namespace Fcpp
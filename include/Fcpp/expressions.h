@@ -0,0 +1,362 @@
+#pragma once
+
+// Lazy elementwise expressions over Fortran arrays
+
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../Fcpp.h"
+#include "algorithms.h"
+
+namespace Fcpp {
+
+template<typename Out, typename E>
+void assign(const Out& out, const E& e);
+
+template<typename Op, typename... Operands>
+class expression;
+
+namespace Fcpp_impl_ {
+
+template<typename S>
+concept scalar_operand = std::is_arithmetic_v<S> || is_complex<S>::value;
+
+template<typename U>
+concept tensor_operand = array_operand<std::remove_cvref_t<U>> ||
+                         array_expression<std::remove_cvref_t<U>>;
+
+// Array referenced by an expression; lvalues are held by reference,
+// temporaries (e.g. a section) by value
+template<typename A>
+class array_leaf {
+public:
+    using array_type = std::remove_cvref_t<A>;
+    using value_type = std::remove_cv_t<typename array_type::value_type>;
+
+    static constexpr int rank = array_rank<array_type>::value;
+    static constexpr std::size_t leaves = 1;
+
+    template<typename T>
+    static constexpr bool vectorizable = std::is_same_v<T,value_type>;
+
+    template<typename U>
+    explicit array_leaf(U&& a) : a_(std::forward<U>(a)) {}
+
+    void collect(const CFI_cdesc_t **desc, std::size_t& k) const { desc[k++] = a_.get(); }
+
+    // Point at the start of the next run
+    void bind(const CFI_index_t *off, const CFI_index_t *inc, std::size_t& k) {
+        ptr_ = base<const value_type>(a_) + off[k];
+        inc_ = inc[k];
+        ++k;
+    }
+
+    value_type operator[](CFI_index_t i) const { return ptr_[i*inc_]; }
+
+#if FCPP_SIMD
+    // W elements starting at i, for unit stride
+    template<typename V>
+    V load(CFI_index_t i) const { return Fcpp_impl_::load<V,true>(ptr_,1,i); }
+#endif
+
+private:
+    A a_;
+    const value_type *ptr_{nullptr};
+    CFI_index_t inc_{1};
+};
+
+template<typename S>
+class scalar_leaf {
+public:
+    using value_type = S;
+
+    static constexpr int rank = -1;
+    static constexpr std::size_t leaves = 0;
+
+    template<typename T>
+    static constexpr bool vectorizable = std::is_same_v<T,value_type>;
+
+    explicit scalar_leaf(S value) : value_(value) {}
+
+    void collect(const CFI_cdesc_t **, std::size_t&) const {}
+    void bind(const CFI_index_t *, const CFI_index_t *, std::size_t&) {}
+
+    value_type operator[](CFI_index_t) const { return value_; }
+
+#if FCPP_SIMD
+    template<typename V>
+    V load(CFI_index_t) const { return V(value_); }
+#endif
+
+private:
+    S value_;
+};
+
+template<typename Op>
+inline constexpr bool builtin_op =
+    std::is_same_v<Op,std::plus<>> || std::is_same_v<Op,std::minus<>> ||
+    std::is_same_v<Op,std::multiplies<>> || std::is_same_v<Op,std::divides<>> ||
+    std::is_same_v<Op,std::negate<>>;
+
+// Rank of an expression: that of its arrays, which must agree
+// (-1 without arrays, -2 on a mismatch)
+template<typename... Operands>
+constexpr int common_rank() {
+    int r = -1;
+    for (int rank : {Operands::rank...}) {
+        if (rank < 0) continue;
+        if (r >= 0 && r != rank) return -2;
+        r = rank;
+    }
+    return r;
+}
+
+// Type a scalar S is converted to in an expression with elements of
+// type T: that of the elements unless this would change its category
+// (e.g. int array * 2.5 stays a double multiplication)
+template<typename T, typename S>
+using scalar_t = std::conditional_t<
+    (std::is_integral_v<S> && std::is_integral_v<T>) ||
+    (std::is_floating_point_v<S> && (std::is_floating_point_v<T> || is_complex<T>::value)),
+    T, S>;
+
+// Operand of an expression: a copy of a subexpression, an array leaf,
+// or a scalar converted to the element type T of the other operands
+template<typename T, typename U>
+auto wrap(U&& u) {
+    using D = std::remove_cvref_t<U>;
+    if constexpr (array_expression<D>) {
+        return D(std::forward<U>(u));
+    } else if constexpr (array_operand<D>) {
+        if constexpr (std::is_lvalue_reference_v<U>) {
+            return array_leaf<const D&>(u);
+        } else {
+            return array_leaf<D>(std::move(u));
+        }
+    } else {
+        static_assert(scalar_operand<D>, "Operands must be arrays, expressions or scalars");
+        if constexpr (std::is_void_v<T>) {
+            return scalar_leaf<D>(u);
+        } else {
+            return scalar_leaf<scalar_t<T,D>>(static_cast<scalar_t<T,D>>(u));
+        }
+    }
+}
+
+template<typename U>
+struct operand_value { using type = void; };
+template<tensor_operand U>
+struct operand_value<U> { using type = std::remove_cv_t<typename std::remove_cvref_t<U>::value_type>; };
+
+template<typename U>
+using operand_value_t = typename operand_value<U>::type;
+
+} // namespace Fcpp_impl_
+
+/**
+ *  Elementwise expression op(operands...) over arrays of the same shape,
+ *  evaluated lazily when assigned to an array, in a single loop without
+ *  temporaries; built by the arithmetic operators below or by map()
+ *
+ *  Arrays are referenced, not copied, so an expression must be assigned
+ *  in the statement that builds it (do not keep it in an auto variable).
+ */
+template<typename Op, typename... Operands>
+class expression {
+public:
+    using expression_tag = void;
+    using value_type = std::remove_cvref_t<
+        std::invoke_result_t<const Op&, typename Operands::value_type...>>;
+
+    static constexpr int rank = Fcpp_impl_::common_rank<Operands...>();
+    static_assert(rank != -2, "Arrays in an expression must have the same rank");
+    static_assert(rank >= 0, "An expression needs at least one array operand");
+
+    static constexpr std::size_t leaves = (Operands::leaves + ...);
+
+    template<typename T>
+    static constexpr bool vectorizable = Fcpp_impl_::builtin_op<Op> &&
+        std::is_same_v<T,value_type> && (Operands::template vectorizable<T> && ...);
+
+    expression(Op op, Operands... operands)
+        : op_(std::move(op)), operands_(std::move(operands)...) {}
+
+    value_type operator[](CFI_index_t i) const {
+        return std::apply([&](const auto&... x) { return op_(x[i]...); }, operands_);
+    }
+
+#if FCPP_SIMD
+    template<typename V>
+    V load(CFI_index_t i) const {
+        return std::apply([&](const auto&... x) { return op_(x.template load<V>(i)...); }, operands_);
+    }
+#endif
+
+    void collect(const CFI_cdesc_t **desc, std::size_t& k) const {
+        std::apply([&](const auto&... x) { (x.collect(desc,k), ...); }, operands_);
+    }
+
+    void bind(const CFI_index_t *off, const CFI_index_t *inc, std::size_t& k) {
+        std::apply([&](auto&... x) { (x.bind(off,inc,k), ...); }, operands_);
+    }
+
+    // Called by the assignment operators of the array classes
+    template<typename Out>
+    void assign_to(const Out& out) const { Fcpp::assign(out,*this); }
+
+private:
+    [[no_unique_address]] Op op_;
+    std::tuple<Operands...> operands_;
+};
+
+namespace Fcpp_impl_ {
+
+// Evaluate a bound expression into a run of n elements at o
+template<typename T, typename X>
+void assign_run(T *o, CFI_index_t inc_o, CFI_index_t n, const X& x, [[maybe_unused]] bool unit) {
+    CFI_index_t i = 0;
+#if FCPP_SIMD
+    if constexpr (simd_type<T> && X::template vectorizable<T>) {
+        if (unit) {
+            using V = simd_t<T>;
+            constexpr CFI_index_t W = V::size();
+            for (; i + W <= n; i += W) {
+                x.template load<V>(i).copy_to(o + i, stdx::element_aligned);
+            }
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        o[i*inc_o] = static_cast<T>(x[i]);
+    }
+}
+
+// Same, with the promise that the run does not overlap the operands
+template<typename T, typename X>
+void assign_run_no_alias(T *FCPP_RESTRICT o, CFI_index_t inc_o, CFI_index_t n, 
+                         const X& x, bool unit) {
+    assign_run(o,inc_o,n,x,unit);
+}
+
+template<bool no_alias_, typename Out, typename E>
+void evaluate(const Out& out, const E& e) {
+
+    using T = element_t<Out>;
+    static_assert(!std::is_const_v<typename Out::value_type>,
+        "The array out is modified");
+    constexpr int rank_ = array_rank<Out>::value;
+
+    auto x = wrap<void>(e);
+    using X = decltype(x);
+    static_assert(X::rank == rank_, "The expression must have the rank of the array");
+
+    constexpr std::size_t K = X::leaves + 1;
+    std::array<const CFI_cdesc_t *,K> desc;
+    desc[0] = out.get();
+    std::size_t n_leaves = 1;
+    x.collect(desc.data(),n_leaves);
+
+    T *po = base<T>(out);
+    for_each_run<rank_,K>(desc, [&](const auto& off, CFI_index_t n, const auto& inc) {
+        std::size_t k = 1;
+        x.bind(off.data(),inc.data(),k);
+        bool unit = true;
+        for (std::size_t a = 0; a < K; ++a) unit = unit && inc[a] == 1;
+        if constexpr (no_alias_) {
+            assign_run_no_alias(po + off[0],inc[0],n,x,unit);
+        } else {
+            assign_run(po + off[0],inc[0],n,x,unit);
+        }
+    });
+}
+
+} // namespace Fcpp_impl_
+
+/**
+ *  Evaluate an expression (or copy the elements of an array) into out,
+ *  which must have the same shape; equivalent to out = e
+ *
+ *  As in a Fortran array assignment, out may appear in e, but only
+ *  elementwise: out = out*2 + b is fine, out = reversed(out) is not.
+ */
+template<typename Out, typename E>
+void assign(const Out& out, const E& e) {
+    Fcpp_impl_::evaluate<false>(out,e);
+}
+
+/**
+ *  Evaluate an expression into out, which does not overlap any of the
+ *  arrays in e; in return the loops need no alias checks and can keep
+ *  the operands in registers across the stores
+ */
+template<typename Out, typename E>
+void assign(const Out& out, const E& e, no_alias_t) {
+    Fcpp_impl_::evaluate<true>(out,e);
+}
+
+/**
+ *  Expression applying f elementwise, e.g.
+ *  out = map([](double x, double y) { return std::hypot(x,y); }, a, b)
+ *
+ *  Scalars are passed to f unchanged.
+ */
+template<typename F, typename... Us>
+    requires (Fcpp_impl_::tensor_operand<Us> || ...)
+auto map(F f, Us&&... us) {
+    return expression<F,decltype(Fcpp_impl_::wrap<void>(std::forward<Us>(us)))...>(
+        std::move(f), Fcpp_impl_::wrap<void>(std::forward<Us>(us))...);
+}
+
+namespace Fcpp_impl_ {
+
+// Element type that scalars in a binary expression are converted to
+template<typename L, typename R>
+using binary_scalar_t = std::conditional_t<tensor_operand<L>,operand_value_t<L>,operand_value_t<R>>;
+
+template<typename Op, typename L, typename R>
+auto make_binary(L&& l, R&& r) {
+    using S = binary_scalar_t<L,R>;
+    using WL = decltype(wrap<S>(std::forward<L>(l)));
+    using WR = decltype(wrap<S>(std::forward<R>(r)));
+    return expression<Op,WL,WR>(Op{}, wrap<S>(std::forward<L>(l)), wrap<S>(std::forward<R>(r)));
+}
+
+template<typename L, typename R>
+concept binary_operands =
+    (tensor_operand<L> && (tensor_operand<R> || scalar_operand<std::remove_cvref_t<R>>)) ||
+    (scalar_operand<std::remove_cvref_t<L>> && tensor_operand<R>);
+
+} // namespace Fcpp_impl_
+
+template<typename L, typename R> requires Fcpp_impl_::binary_operands<L,R>
+auto operator+(L&& l, R&& r) {
+    return Fcpp_impl_::make_binary<std::plus<>>(std::forward<L>(l),std::forward<R>(r));
+}
+
+template<typename L, typename R> requires Fcpp_impl_::binary_operands<L,R>
+auto operator-(L&& l, R&& r) {
+    return Fcpp_impl_::make_binary<std::minus<>>(std::forward<L>(l),std::forward<R>(r));
+}
+
+template<typename L, typename R> requires Fcpp_impl_::binary_operands<L,R>
+auto operator*(L&& l, R&& r) {
+    return Fcpp_impl_::make_binary<std::multiplies<>>(std::forward<L>(l),std::forward<R>(r));
+}
+
+template<typename L, typename R> requires Fcpp_impl_::binary_operands<L,R>
+auto operator/(L&& l, R&& r) {
+    return Fcpp_impl_::make_binary<std::divides<>>(std::forward<L>(l),std::forward<R>(r));
+}
+
+template<Fcpp_impl_::tensor_operand U>
+auto operator-(U&& u) {
+    using W = decltype(Fcpp_impl_::wrap<void>(std::forward<U>(u)));
+    return expression<std::negate<>,W>(std::negate<>{}, Fcpp_impl_::wrap<void>(std::forward<U>(u)));
+}
+
+} // namespace Fcpp
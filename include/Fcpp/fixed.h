@@ -0,0 +1,239 @@
+#pragma once
+
+// Descriptors of small arrays whose shape is known at compile time
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "../Fcpp.h"
+
+namespace Fcpp {
+
+/**
+ *  Extents of a column-major array fixed at compile time,
+ *  e.g. extents<3,3> for a 3 x 3 tensor
+ */
+template<CFI_index_t... N>
+struct extents {
+    static_assert(((N >= 0) && ...), "Extents must be non-negative");
+
+    static constexpr int rank = sizeof...(N);
+    static constexpr std::array<CFI_index_t,rank> value{N...};
+    static constexpr CFI_index_t size = (N * ... * CFI_index_t(1));
+
+    // Element strides of the contiguous layout
+    static constexpr std::array<CFI_index_t,rank> strides = [] {
+        std::array<CFI_index_t,rank> sm{};
+        CFI_index_t s = 1;
+        for (int d = 0; d < rank; ++d) {
+            sm[d] = s;
+            s *= value[d];
+        }
+        return sm;
+    }();
+};
+
+template<typename T, typename Extents>
+class cdesc_fixed;
+
+/**
+ *  Descriptor of a contiguous array with the extents Ext, e.g.
+ *  cdesc_fixed<double,extents<3,3>>, passed to Fortran like a cdesc
+ *
+ *  Extents, strides and offsets are constant expressions, so that
+ *  indexing and loops over the extents fold at compile time; only the
+ *  address of the elements is read at run time.
+ */
+template<typename T, CFI_index_t... N>
+class cdesc_fixed<T,extents<N...>> {
+public:
+
+    using extents_type = extents<N...>;
+    static constexpr int rank_ = extents_type::rank;
+
+    static_assert(rank_ <= CFI_MAX_RANK,
+        "The maximum allowed rank is 15");
+    static_assert(extents_type::size > 0, "Extents must be positive");
+    static_assert(Fcpp_impl_::is_supported_type<T>,
+        "The type has no interoperable kind on this platform");
+
+    using value_type = T;
+    using size_type = std::size_t;
+
+    using reference = T&;
+    using const_reference = const T&;
+
+    using pointer = T*;
+    using const_pointer = const T*;
+
+    constexpr CFI_type_t type() const { return Fcpp_impl_::type<T>(); };
+    static constexpr CFI_rank_t rank() { return rank_; };
+
+    static constexpr std::size_t extent(int d) {
+        FCPP_CHECK_BOUNDS(0 <= d && d < rank_);
+        return static_cast<std::size_t>(extents_type::value[d]);
+    }
+
+    template<int d>
+    static constexpr std::size_t extent() {
+        static_assert(0 <= d && d < rank_);
+        return static_cast<std::size_t>(extents_type::value[d]);
+    }
+
+    static constexpr size_type size() { return static_cast<size_type>(extents_type::size); }
+    static constexpr bool empty() { return size() == 0; }
+    static constexpr bool is_contiguous() { return true; }
+
+    // (A template, so that C arrays prefer the constructor below)
+    template<typename P>
+        requires (std::is_pointer_v<P> && std::is_convertible_v<P,T*>)
+    explicit cdesc_fixed(P ptr) : ptr_(ptr) {
+        constexpr auto ext = extents_type::value;
+        [[maybe_unused]] int status = CFI_establish(
+            this->get(),
+            const_cast<std::remove_const_t<T>*>(ptr),
+            CFI_attribute_other,
+            this->type(),
+            sizeof(T),
+            rank_,
+            rank_ > 0 ? ext.data() : nullptr
+        );
+        FCPP_CHECK(status == CFI_SUCCESS);
+        FCPP_RECORD(establish,this->get());
+    }
+
+    // Constructors from C arrays and std::array of the right size
+    cdesc_fixed(T (&ref)[extents_type::size]) : cdesc_fixed(+ref) {}
+
+    cdesc_fixed(std::array<std::remove_const_t<T>,extents_type::size>& buffer)
+        : cdesc_fixed(buffer.data()) {}
+
+    cdesc_fixed(const std::array<std::remove_const_t<T>,extents_type::size>& buffer)
+        requires std::is_const_v<T> : cdesc_fixed(buffer.data()) {}
+
+    cdesc_fixed(const cdesc_fixed&) = default;
+    cdesc_fixed& operator=(const cdesc_fixed&) = default;
+
+    // Evaluate an elementwise expression (Fcpp/expressions.h) into the elements
+    template<Fcpp_impl_::array_expression E>
+    cdesc_fixed& operator=(const E& e) requires (!std::is_const_v<T>) {
+        e.assign_to(*this);
+        return *this;
+    }
+
+    // Return pointer to the underlying descriptor
+    constexpr auto get() const { return (CFI_cdesc_t *) &desc_; }
+
+    // Implicit cast to C-descriptor pointer
+    operator CFI_cdesc_t* () const { return this->get(); }
+
+    // Offset of an element, a constant expression for constant indices
+    template<typename... Idx>
+    static constexpr std::ptrdiff_t offset(Idx... idx) {
+        static_assert(sizeof...(Idx) == rank_,
+            "Number of indices must be equal to the rank");
+        std::ptrdiff_t off = 0;
+        int d = 0;
+        ((off += static_cast<std::ptrdiff_t>(idx)*extents_type::strides[d++]), ...);
+        return off;
+    }
+
+    // Array subscript operators
+    T& operator[](std::size_t idx) {
+        static_assert(rank_ == 1,
+            "Rank must be 1 to use array subscript operator");
+        FCPP_CHECK_BOUNDS(idx < size());
+        return ptr_[idx];
+    }
+    const T& operator[](std::size_t idx) const {
+        static_assert(rank_ == 1,
+            "Rank must be 1 to use array subscript operator");
+        FCPP_CHECK_BOUNDS(idx < size());
+        return ptr_[idx];
+    }
+
+    template<typename... Idx>
+    T& operator()(Idx... idx) {
+        FCPP_CHECK_BOUNDS(in_bounds(idx...));
+        return ptr_[offset(idx...)];
+    }
+    template<typename... Idx>
+    const T& operator()(Idx... idx) const {
+        FCPP_CHECK_BOUNDS(in_bounds(idx...));
+        return ptr_[offset(idx...)];
+    }
+
+    // Element with indices known at compile time, e.g. a.at<1,2>()
+    template<CFI_index_t... idx>
+    T& at() {
+        static_assert(sizeof...(idx) == rank_,
+            "Number of indices must be equal to the rank");
+        static_assert(((0 <= idx && idx < N) && ...), "Index out of bounds");
+        return ptr_[offset(idx...)];
+    }
+    template<CFI_index_t... idx>
+    const T& at() const {
+        static_assert(sizeof...(idx) == rank_,
+            "Number of indices must be equal to the rank");
+        static_assert(((0 <= idx && idx < N) && ...), "Index out of bounds");
+        return ptr_[offset(idx...)];
+    }
+
+    pointer data() { return ptr_; }
+    const_pointer data() const { return ptr_; }
+
+    // Iterators over all elements, in array element order
+    T* begin() { return ptr_; }
+    T* end() { return ptr_ + size(); }
+    const T* begin() const { return ptr_; }
+    const T* end() const { return ptr_ + size(); }
+    const T* cbegin() const { return begin(); }
+    const T* cend() const { return end(); }
+
+    // Call f with every multi-index in array element order, fully unrolled;
+    // the indices are std::integral_constant, so a.at<i,j>() can be used
+    // inside, e.g. a.for_each_index([&](auto i, auto j) { ... })
+    template<typename F>
+    static constexpr void for_each_index(F&& f) {
+        for_each_index_<0>(f);
+    }
+
+private:
+
+    template<typename... Idx>
+    static constexpr bool in_bounds(Idx... idx) {
+        int d = 0;
+        return ((0 <= static_cast<CFI_index_t>(idx) &&
+                 static_cast<CFI_index_t>(idx) < extents_type::value[d++]) && ...);
+    }
+
+    template<std::size_t k, typename F, typename... Idx>
+    static constexpr void for_each_index_(F& f, Idx... idx) {
+        if constexpr (k == rank_) {
+            f(idx...);
+        } else {
+            // Run the last dimension in the outer loop
+            constexpr CFI_index_t n = extents_type::value[rank_ - 1 - k];
+            [&]<CFI_index_t... i>(std::integer_sequence<CFI_index_t,i...>) {
+                (for_each_index_<k+1>(f,std::integral_constant<CFI_index_t,i>{},idx...), ...);
+            }(std::make_integer_sequence<CFI_index_t,n>{});
+        }
+    }
+
+    T *ptr_;
+    CFI_CDESC_T(rank_) desc_;
+};
+
+namespace Fcpp_impl_ {
+
+template<typename T, typename Ext>
+struct array_rank<Fcpp::cdesc_fixed<T,Ext>> : std::integral_constant<int,Ext::rank> {};
+
+} // namespace Fcpp_impl_
+
+} // namespace Fcpp
+
+template<typename T, typename Ext>
+inline constexpr bool std::ranges::enable_borrowed_range<Fcpp::cdesc_fixed<T,Ext>> = true;
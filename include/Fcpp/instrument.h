@@ -0,0 +1,179 @@
+#pragma once
+
+// Instrumentation of cross-language calls; without FCPP_INSTRUMENT=1 
+// the wrappers reduce to plain calls
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "../Fcpp.h"
+
+namespace Fcpp {
+
+#if FCPP_INSTRUMENT
+
+// Statistics of the calls made through instrumented_call, by name
+struct call_statistics {
+    std::uint64_t calls = 0;
+    std::uint64_t nanoseconds = 0;
+    std::uint64_t bytes = 0;
+    // Descriptor arguments that were not contiguous, which Fortran
+    // copies in and out for explicit-shape or CONTIGUOUS dummies
+    std::uint64_t noncontiguous_args = 0;
+};
+
+// Totals of the events of one kind
+struct event_statistics {
+    std::uint64_t count = 0;
+    std::uint64_t bytes = 0;
+};
+
+namespace Fcpp_impl_ {
+
+struct call_registry {
+    std::mutex mutex;
+    std::map<std::string,call_statistics> calls;
+};
+
+inline call_registry& calls_() {
+    static call_registry r;
+    return r;
+}
+
+// Descriptor of an argument, if it is one or wraps one
+template<typename A>
+const CFI_cdesc_t* descriptor_of(const A& a) {
+    if constexpr (std::is_convertible_v<const A&, const CFI_cdesc_t*>) {
+        return a;
+    } else if constexpr (requires { { a.get() } -> std::convertible_to<const CFI_cdesc_t*>; }) {
+        return a.get();
+    } else {
+        return nullptr;
+    }
+}
+
+} // namespace Fcpp_impl_
+
+// Install a callback receiving every event (e.g. to forward the calls 
+// to ITT or NVTX ranges), returning the previous one
+inline instrumentation_callback set_instrumentation_callback(instrumentation_callback cb) {
+    return Fcpp_impl_::callback_.exchange(cb);
+}
+
+inline event_statistics statistics(event_kind kind) {
+    const auto k = static_cast<int>(kind);
+    return { Fcpp_impl_::counters_.count[k].load(std::memory_order_relaxed),
+             Fcpp_impl_::counters_.bytes[k].load(std::memory_order_relaxed) };
+}
+
+inline std::map<std::string,call_statistics> call_summary() {
+    auto& r = Fcpp_impl_::calls_();
+    std::lock_guard lock(r.mutex);
+    return r.calls;
+}
+
+inline void reset_statistics() {
+    for (auto& c : Fcpp_impl_::counters_.count) c.store(0);
+    for (auto& b : Fcpp_impl_::counters_.bytes) b.store(0);
+    auto& r = Fcpp_impl_::calls_();
+    std::lock_guard lock(r.mutex);
+    r.calls.clear();
+}
+
+/**
+ *  Call f(args...) (typically a bind(c) Fortran procedure), timing it 
+ *  and recording the size and contiguity of its descriptor arguments
+ *  under the given name
+ */
+template<typename F, typename... Args>
+decltype(auto) instrumented_call(const char *name, F&& f, Args&&... args) {
+
+    std::uint64_t bytes = 0, noncontiguous = 0;
+    auto inspect = [&](const CFI_cdesc_t *d) {
+        if (!d) return;
+        bytes += Fcpp_impl_::described_bytes(d);
+        if (d->base_addr && CFI_is_contiguous(d) != 1) ++noncontiguous;
+    };
+    (inspect(Fcpp_impl_::descriptor_of(args)), ...);
+
+    Fcpp_impl_::record(event_kind::call_begin, bytes, name);
+    const auto start = std::chrono::steady_clock::now();
+
+    struct finish {
+        const char *name;
+        std::uint64_t bytes, noncontiguous;
+        std::chrono::steady_clock::time_point start;
+        ~finish() {
+            const auto ns = static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count());
+            {
+                auto& r = Fcpp_impl_::calls_();
+                std::lock_guard lock(r.mutex);
+                auto& s = r.calls[name];
+                ++s.calls;
+                s.nanoseconds += ns;
+                s.bytes += bytes;
+                s.noncontiguous_args += noncontiguous;
+            }
+            Fcpp_impl_::record(event_kind::call_end, bytes, name, ns);
+        }
+    } scope{name, bytes, noncontiguous, start};
+
+    return std::forward<F>(f)(std::forward<Args>(args)...);
+}
+
+// Table of the event counters and the instrumented calls
+inline void write_summary(std::ostream& os) {
+    static const char *kinds[] = {"establish", "section", "contiguity_check", 
+                                  "strided_iteration"};
+    os << "Fcpp instrumentation summary\n";
+    for (int k = 0; k < 4; ++k) {
+        const auto s = statistics(static_cast<event_kind>(k));
+        os << "  " << std::left << std::setw(20) << kinds[k] 
+           << std::right << std::setw(12) << s.count 
+           << std::setw(16) << s.bytes << " bytes\n";
+    }
+    const auto calls = call_summary();
+    if (!calls.empty()) {
+        os << "  " << std::left << std::setw(24) << "call" << std::right 
+           << std::setw(10) << "calls" << std::setw(14) << "time [ms]" 
+           << std::setw(16) << "bytes" << std::setw(14) << "noncontig\n";
+        for (const auto& [name, s] : calls) {
+            os << "  " << std::left << std::setw(24) << name << std::right 
+               << std::setw(10) << s.calls 
+               << std::setw(14) << std::fixed << std::setprecision(3) << s.nanoseconds*1e-6
+               << std::setw(16) << s.bytes 
+               << std::setw(13) << s.noncontiguous_args << "\n";
+        }
+    }
+}
+
+// Print the summary to stderr when the program exits
+inline void write_summary_at_exit() {
+    std::atexit([] { write_summary(std::cerr); });
+}
+
+#define FCPP_CALL(f, ...) Fcpp::instrumented_call(#f, f __VA_OPT__(,) __VA_ARGS__)
+
+#else
+
+template<typename F, typename... Args>
+decltype(auto) instrumented_call(const char *, F&& f, Args&&... args) {
+    return std::forward<F>(f)(std::forward<Args>(args)...);
+}
+
+#define FCPP_CALL(f, ...) f(__VA_ARGS__)
+
+#endif
+
+} // namespace Fcpp
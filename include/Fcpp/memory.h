@@ -0,0 +1,347 @@
+#pragma once
+
+#include <memory>
+#include <new>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include <type_traits>
+#include <cstddef>
+#include <cstring>
+
+#include "../Fcpp.h"
+
+namespace Fcpp {
+
+/**
+ *  Allocator returning storage aligned to Alignment bytes,
+ *  e.g. 32 (AVX2) or 64 (AVX-512, cache line)
+ */
+template<typename T, std::size_t Alignment = 64>
+struct aligned_allocator {
+
+    static_assert((Alignment & (Alignment - 1)) == 0, 
+        "Alignment must be a power of two");
+    static_assert(Alignment >= alignof(T),
+        "Alignment must not be smaller than the alignment of the type");
+
+    using value_type = T;
+
+    static constexpr std::size_t alignment = Alignment;
+
+    template<typename U>
+    struct rebind { using other = aligned_allocator<U,Alignment>; };
+
+    constexpr aligned_allocator() noexcept = default;
+
+    template<typename U>
+    constexpr aligned_allocator(const aligned_allocator<U,Alignment>&) noexcept {}
+
+    [[nodiscard]] T* allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(::operator new(n*sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* p, std::size_t) noexcept {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template<typename U>
+    friend constexpr bool operator==(const aligned_allocator&, 
+                                     const aligned_allocator<U,Alignment>&) noexcept {
+        return true;
+    }
+};
+
+// Vector type with aligned storage, which can be passed to cdesc
+template<typename T, std::size_t Alignment = 64>
+using aligned_vector = std::vector<T,aligned_allocator<T,Alignment>>;
+
+namespace Fcpp_impl_ {
+
+// Guaranteed alignment of the storage returned by an allocator
+template<typename Allocator>
+constexpr std::size_t alignment_of() {
+    if constexpr (requires { Allocator::alignment; }) {
+        return Allocator::alignment;
+    } else {
+        return alignof(typename Allocator::value_type);
+    }
+}
+
+} // namespace Fcpp_impl_
+
+/**
+ *  Leading dimension for n elements of type T, rounded up to a multiple of 
+ *  the alignment. If avoid_aliasing is set, a leading dimension spanning a
+ *  multiple of 4 KiB is padded further, so that consecutive columns do not
+ *  map onto the same cache sets (4K aliasing).
+ */
+template<typename T, std::size_t Alignment = 64>
+constexpr std::size_t padded_extent(std::size_t n, bool avoid_aliasing = true) {
+    constexpr std::size_t unit = std::lcm(Alignment,sizeof(T)) / sizeof(T);
+    std::size_t ld = (n + unit - 1) / unit * unit;
+    if (avoid_aliasing && ld > 0 && (ld*sizeof(T)) % 4096 == 0) {
+        ld += unit;
+    }
+    return ld;
+}
+
+/**
+ *  Owning rank-N array with storage obtained from a C++ allocator
+ *
+ *  Resizing within the current capacity reuses the storage, and with a
+ *  std::pmr::polymorphic_allocator the buffer can be drawn from a pool or
+ *  arena (e.g. std::pmr::unsynchronized_pool_resource), which removes the
+ *  allocation traffic of scratch arrays that are resized every call.
+ *
+ *  The descriptor has attribute other, so it can be passed to assumed-shape
+ *  dummy arguments; the Fortran side must not deallocate it.
+ */
+template<typename T, int rank_ = 1, typename Allocator = std::allocator<T>>
+class cdesc_buffer {
+public:
+
+    static_assert(rank_ >= 0, "Rank must be non-negative");
+    static_assert(rank_ <= CFI_MAX_RANK, 
+        "The maximum allowed rank is 15");
+    static_assert(std::is_trivially_copyable_v<T> && 
+                  std::is_trivially_destructible_v<T>,
+        "Elements of a Fortran array must be trivially copyable");
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using allocator_type = Allocator;
+
+    using reference = T&;
+    using const_reference = const T&;
+
+    using pointer = T*;
+    using const_pointer = const T*;
+
+    // Guaranteed alignment of the storage in bytes
+    static constexpr std::size_t alignment = Fcpp_impl_::alignment_of<Allocator>();
+
+    // Views used for element access from C++; view() requires a
+    // contiguous array, strided_view() also takes the padded leading
+    // dimension of resize_padded
+    using view_type = cdesc_ptr<T,rank_,attr::other,layout::contiguous>;
+    using strided_view_type = cdesc_ptr<T,rank_>;
+
+    constexpr CFI_type_t type() const { return Fcpp_impl_::type<T>(); };
+    constexpr CFI_rank_t rank() const { return rank_; };
+
+    cdesc_buffer() : cdesc_buffer(Allocator()) {}
+
+    explicit cdesc_buffer(const Allocator& alloc) : alloc_(alloc) {
+        CFI_index_t extents[rank_ > 0 ? rank_ : 1] = {};
+        this->establish(extents);
+    }
+
+    template<typename... Exts>
+        requires (sizeof...(Exts) == rank_ && (std::is_integral_v<Exts> && ...))
+    explicit cdesc_buffer(Exts... exts) : cdesc_buffer(Allocator()) {
+        this->resize(exts...);
+    }
+
+    cdesc_buffer(const cdesc_buffer&) = delete;
+    cdesc_buffer& operator=(const cdesc_buffer&) = delete;
+
+    cdesc_buffer(cdesc_buffer&& other) noexcept
+        : alloc_(std::move(other.alloc_)), desc_(other.desc_),
+          data_(std::exchange(other.data_,nullptr)),
+          capacity_(std::exchange(other.capacity_,0)) {
+        other.clear();
+    }
+
+    // As for std::vector, the storage is taken over unless the allocators
+    // differ and do not propagate (e.g. polymorphic allocators of two
+    // memory resources), in which case the elements are copied into
+    // storage from this allocator
+    cdesc_buffer& operator=(cdesc_buffer&& other) noexcept(
+            alloc_traits::propagate_on_container_move_assignment::value ||
+            alloc_traits::is_always_equal::value) {
+        if (this != &other) {
+            if constexpr (!alloc_traits::propagate_on_container_move_assignment::value &&
+                          !alloc_traits::is_always_equal::value) {
+                if (alloc_ != other.alloc_) {
+                    const size_type n = other.storage_size();
+                    this->reserve(n);
+                    if (n > 0) std::memcpy(data_, other.data_, n*sizeof(T));
+                    desc_ = other.desc_;
+                    this->get()->base_addr = data_ ? static_cast<void*>(data_) 
+                                                   : Fcpp_impl_::empty_base_addr();
+                    other.clear();
+                    return *this;
+                }
+            }
+            this->release();
+            if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+                alloc_ = std::move(other.alloc_);
+            }
+            desc_ = other.desc_;
+            data_ = std::exchange(other.data_,nullptr);
+            capacity_ = std::exchange(other.capacity_,0);
+            other.clear();
+        }
+        return *this;
+    }
+
+    ~cdesc_buffer() { this->release(); }
+
+    // Return pointer to the underlying descriptor
+    constexpr auto get() const { return (CFI_cdesc_t *) &desc_; }
+
+    // Implicit cast to C-descriptor pointer
+    operator CFI_cdesc_t* () { return this->get(); }
+
+    view_type view() const { return view_type(this->get()); }
+    strided_view_type strided_view() const { return strided_view_type(this->get()); }
+
+    allocator_type get_allocator() const { return alloc_; }
+
+    inline std::size_t extent(int d) const {
+        FCPP_CHECK_BOUNDS(0 <= d && d < rank_);
+        return this->get()->dim[d].extent;
+    }
+
+    size_type size() const {
+        size_type n = 1;
+        for (int d = 0; d < rank_; ++d) {
+            n *= this->extent(d);
+        }
+        return n;
+    }
+
+    size_type capacity() const { return capacity_; }
+
+    pointer data() const { return std::assume_aligned<alignment>(data_); }
+
+    // Number of elements used to store the leading dimension
+    size_type leading_dim() const {
+        if constexpr (rank_ > 1) {
+            return this->get()->dim[1].sm / sizeof(T);
+        } else {
+            return rank_ == 1 ? this->extent(0) : 1;
+        }
+    }
+
+    // Reshape the array to the given extents, reallocating only when the 
+    // capacity is exceeded; the contents are not preserved
+    template<typename... Exts>
+    void resize(Exts... exts) {
+        static_assert(sizeof...(Exts) == rank_,
+            "Number of extents must be equal to the rank");
+        CFI_index_t extents[rank_ > 0 ? rank_ : 1] = { static_cast<CFI_index_t>(exts)... };
+
+        size_type n = 1;
+        for (int d = 0; d < rank_; ++d) {
+            FCPP_CHECK(extents[d] >= 0);
+            n *= static_cast<size_type>(extents[d]);
+        }
+        this->reserve(n);
+        this->establish(extents);
+    }
+
+    // Like resize, but the leading dimension is padded to a multiple
+    // of the alignment (see padded_extent), so that each column starts
+    // on an aligned address
+    template<typename... Exts>
+    void resize_padded(Exts... exts) {
+        static_assert(rank_ > 0, "Rank must be positive to pad the leading dimension");
+        static_assert(sizeof...(Exts) == rank_,
+            "Number of extents must be equal to the rank");
+        CFI_index_t extents[rank_] = { static_cast<CFI_index_t>(exts)... };
+
+        const auto ld = static_cast<CFI_index_t>(
+            padded_extent<T,alignment>(static_cast<size_type>(extents[0])));
+        size_type n = static_cast<size_type>(ld);
+        for (int d = 1; d < rank_; ++d) {
+            FCPP_CHECK(extents[d] >= 0);
+            n *= static_cast<size_type>(extents[d]);
+        }
+        this->reserve(n);
+        if (n == 0) {
+            this->establish(extents);
+            return;
+        }
+
+        [[maybe_unused]] int status = Fcpp_impl_::establish_padded<rank_>(
+            this->get(), data_, CFI_attribute_other, this->type(), 
+            sizeof(T), ld, extents);
+        FCPP_CHECK(status == CFI_SUCCESS);
+    }
+
+    // Make sure the storage can hold at least n elements
+    // (the existing contents are not preserved on reallocation)
+    void reserve(size_type n) {
+        if (n > capacity_) {
+            this->release();
+            data_ = alloc_traits::allocate(alloc_,n);
+            capacity_ = n;
+        }
+    }
+
+    // Set all extents to zero, keeping the storage
+    void clear() {
+        CFI_index_t extents[rank_ > 0 ? rank_ : 1] = {};
+        this->establish(extents);
+    }
+
+    // Return the storage to the allocator
+    void release() {
+        if (data_) {
+            alloc_traits::deallocate(alloc_,data_,capacity_);
+            data_ = nullptr;
+            capacity_ = 0;
+        }
+        this->clear();
+    }
+
+    // Iterator support (elements in column-major order);
+    // not available for a padded leading dimension
+    T* begin() const { 
+        FCPP_CHECK(rank_ == 0 || this->leading_dim() == this->extent(0));
+        return data_; 
+    }
+    T* end() const { return this->begin() + this->size(); }
+
+private:
+
+    using alloc_traits = std::allocator_traits<Allocator>;
+
+    // Number of elements spanned by the storage of the array,
+    // including the padding of the leading dimension
+    size_type storage_size() const {
+        if (this->size() == 0) return 0;
+        size_type n = this->leading_dim();
+        for (int d = 1; d < rank_; ++d) {
+            n *= this->extent(d);
+        }
+        return n;
+    }
+
+    void establish(const CFI_index_t extents[]) {
+        [[maybe_unused]] int status = CFI_establish(
+            this->get(),
+            data_ ? static_cast<void*>(data_) : Fcpp_impl_::empty_base_addr(),
+            CFI_attribute_other,
+            this->type(),
+            sizeof(T),
+            rank_,
+            extents
+        );
+        FCPP_CHECK(status == CFI_SUCCESS);
+        FCPP_RECORD(establish,this->get());
+    }
+
+    [[no_unique_address]] Allocator alloc_;
+    CFI_CDESC_T(rank_) desc_;
+    pointer data_{nullptr};
+    size_type capacity_{0};
+};
+
+} // namespace Fcpp
@@ -0,0 +1,358 @@
+#pragma once
+
+// Memory-mapped arrays (POSIX)
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../Fcpp.h"
+#include "pack.h"
+
+namespace Fcpp {
+
+enum class map_mode {
+    read_only,      // PROT_READ, MAP_SHARED
+    shared,         // writes go to the file (MAP_SHARED)
+    copy_on_write   // writes are private to the process (MAP_PRIVATE)
+};
+
+// Expected access pattern, passed on to madvise
+enum class access_hint { normal, sequential, random, will_need };
+
+struct map_options {
+    map_mode mode = map_mode::read_only;
+    access_hint hint = access_hint::normal;
+    // Request transparent huge pages (MADV_HUGEPAGE), where the kernel
+    // supports them for file mappings
+    bool huge_pages = false;
+};
+
+/**
+ *  Header of the array files read by mapped_array::open and written by
+ *  save_array, followed by the elements in column-major order starting 
+ *  at data_offset (a multiple of the page size). Fields are in native
+ *  byte order.
+ */
+struct array_file_header {
+    char magic[8];              // "FCPPARR1"
+    std::int32_t type;          // CFI type code
+    std::int32_t elem_len;
+    std::int32_t rank;
+    std::int32_t reserved;
+    std::int64_t data_offset;
+    std::int64_t extent[CFI_MAX_RANK];
+};
+
+namespace Fcpp_impl_ {
+
+inline constexpr char array_file_magic[8] = {'F','C','P','P','A','R','R','1'};
+inline constexpr std::int64_t array_file_data_offset = 4096;
+
+[[noreturn]] inline void throw_errno(const std::string& what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+// File descriptor closed on scope exit
+struct file_handle {
+    int fd;
+    ~file_handle() { if (fd >= 0) ::close(fd); }
+};
+
+inline int advice(access_hint hint) {
+    switch (hint) {
+        case access_hint::sequential: return MADV_SEQUENTIAL;
+        case access_hint::random: return MADV_RANDOM;
+        case access_hint::will_need: return MADV_WILLNEED;
+        default: return MADV_NORMAL;
+    }
+}
+
+// Read and check the header of an array file
+template<typename T, int rank_>
+array_file_header read_array_header(const std::string& path) {
+    file_handle f{::open(path.c_str(), O_RDONLY)};
+    if (f.fd < 0) throw_errno("open " + path);
+
+    array_file_header h;
+    if (::pread(f.fd, &h, sizeof(h), 0) != static_cast<ssize_t>(sizeof(h))) {
+        throw std::runtime_error(path + ": truncated array file header");
+    }
+    if (std::memcmp(h.magic, array_file_magic, sizeof(h.magic)) != 0) {
+        throw std::runtime_error(path + ": not an array file");
+    }
+    if (h.rank != rank_) {
+        throw std::runtime_error(path + ": rank " + std::to_string(h.rank) + 
+            " does not match " + std::to_string(rank_));
+    }
+    if (h.type != type<T>() || h.elem_len != static_cast<std::int32_t>(sizeof(T))) {
+        throw std::runtime_error(path + ": element type does not match");
+    }
+
+    // Extents and offset come from the file and are not trusted; files
+    // of empty arrays may end with the header
+    std::size_t bytes = 0;
+    CFI_index_t extents[rank_ > 0 ? rank_ : 1];
+    for (int d = 0; d < rank_; ++d) extents[d] = static_cast<CFI_index_t>(h.extent[d]);
+    if (!storage_bytes(extents, rank_, sizeof(T), bytes)) {
+        throw std::runtime_error(path + ": invalid array extents");
+    }
+    if (h.data_offset < static_cast<std::int64_t>(sizeof(h)) || 
+        h.data_offset % static_cast<std::int64_t>(alignof(T)) != 0) {
+        throw std::runtime_error(path + ": invalid data offset");
+    }
+    struct stat st;
+    if (::fstat(f.fd, &st) != 0) throw_errno("stat " + path);
+    const std::size_t size = static_cast<std::size_t>(st.st_size);
+    const std::size_t offset = static_cast<std::size_t>(h.data_offset);
+    if (bytes > 0 && (offset > size || bytes > size - offset)) {
+        throw std::runtime_error(path + ": file is smaller than the array");
+    }
+    return h;
+}
+
+// Create (or truncate) an array file, writing only the header
+template<typename T, int rank_>
+void write_array_header(const std::string& path, const CFI_index_t *extents) {
+    array_file_header h{};
+    std::memcpy(h.magic, array_file_magic, sizeof(h.magic));
+    h.type = type<T>();
+    h.elem_len = sizeof(T);
+    h.rank = rank_;
+    h.data_offset = array_file_data_offset;
+    for (int d = 0; d < rank_; ++d) h.extent[d] = extents[d];
+
+    file_handle f{::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644)};
+    if (f.fd < 0) throw_errno("open " + path);
+    if (::pwrite(f.fd, &h, sizeof(h), 0) != static_cast<ssize_t>(sizeof(h))) {
+        throw_errno("write " + path);
+    }
+}
+
+} // namespace Fcpp_impl_
+
+/**
+ *  Array of rank rank_ backed by a memory-mapped file; the pages are 
+ *  loaded on demand, so the descriptor is available right away and no 
+ *  copy of the file is held in memory
+ *
+ *  Owns the mapping (move-only). With map_mode::read_only the elements
+ *  must not be modified, also not from Fortran (intent(in)).
+ */
+template<typename T, int rank_ = 1>
+class mapped_array {
+public:
+
+    static_assert(rank_ >= 0, "Rank must be non-negative");
+    static_assert(rank_ <= CFI_MAX_RANK, 
+        "The maximum allowed rank is 15");
+    static_assert(std::is_trivially_copyable_v<T>,
+        "Elements of a mapped array must be trivially copyable");
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using extents_type = std::array<CFI_index_t,rank_>;
+    using view_type = cdesc_ptr<T,rank_,attr::other,layout::contiguous>;
+
+    constexpr CFI_type_t type() const { return Fcpp_impl_::type<T>(); };
+    constexpr CFI_rank_t rank() const { return rank_; };
+
+    // Map a file holding only the elements, in column-major order,
+    // starting at byte offset
+    static mapped_array open_raw(const std::string& path, const extents_type& extents,
+                                 map_options opts = {}, std::size_t offset = 0) {
+        mapped_array a;
+        a.map(path, extents, opts, offset, false);
+        return a;
+    }
+
+    // Map a file written by save_array or create, checking the element
+    // type and the rank against the header
+    static mapped_array open(const std::string& path, map_options opts = {}) {
+        const array_file_header h = Fcpp_impl_::read_array_header<T,rank_>(path);
+        extents_type extents;
+        for (int d = 0; d < rank_; ++d) extents[d] = h.extent[d];
+        mapped_array a;
+        a.map(path, extents, opts, static_cast<std::size_t>(h.data_offset), false);
+        return a;
+    }
+
+    // Create (or truncate) a file with a header and room for the 
+    // elements, and map it for writing
+    static mapped_array create(const std::string& path, const extents_type& extents,
+                               map_options opts = {.mode = map_mode::shared}) {
+        FCPP_CHECK(opts.mode == map_mode::shared);
+        Fcpp_impl_::write_array_header<T,rank_>(path, extents.data());
+        mapped_array a;
+        a.map(path, extents, opts, Fcpp_impl_::array_file_data_offset, true);
+        return a;
+    }
+
+    mapped_array(const mapped_array&) = delete;
+    mapped_array& operator=(const mapped_array&) = delete;
+
+    mapped_array(mapped_array&& other) noexcept 
+        : desc_(other.desc_),
+          map_(std::exchange(other.map_,nullptr)), 
+          map_len_(std::exchange(other.map_len_,0)) {}
+
+    mapped_array& operator=(mapped_array&& other) noexcept {
+        if (this != &other) {
+            this->unmap();
+            desc_ = other.desc_;
+            map_ = std::exchange(other.map_,nullptr);
+            map_len_ = std::exchange(other.map_len_,0);
+        }
+        return *this;
+    }
+
+    ~mapped_array() { this->unmap(); }
+
+    // Return pointer to the underlying descriptor
+    constexpr auto get() const { return (CFI_cdesc_t *) &desc_; }
+
+    // Implicit cast to C-descriptor pointer
+    operator CFI_cdesc_t* () { return this->get(); }
+
+    view_type view() const { return view_type(this->get()); }
+
+    inline std::size_t extent(int d) const {
+        FCPP_CHECK_BOUNDS(0 <= d && d < rank_);
+        return this->get()->dim[d].extent;
+    }
+
+    size_type size() const {
+        size_type n = 1;
+        for (int d = 0; d < rank_; ++d) {
+            n *= this->extent(d);
+        }
+        return n;
+    }
+
+    T* data() const { return static_cast<T*>(this->get()->base_addr); }
+    T* begin() const { return this->data(); }
+    T* end() const { return this->data() + this->size(); }
+
+    // Give a new access pattern hint for the whole array
+    void advise(access_hint hint) const {
+        if (map_) ::madvise(map_, map_len_, Fcpp_impl_::advice(hint));
+    }
+
+    // Write modified pages back to the file (map_mode::shared)
+    void sync() const {
+        if (map_ && ::msync(map_, map_len_, MS_SYNC) != 0) {
+            Fcpp_impl_::throw_errno("msync");
+        }
+    }
+
+private:
+
+    mapped_array() = default;
+
+    void map(const std::string& path, const extents_type& extents, 
+             map_options opts, std::size_t offset, bool grow) {
+
+        std::size_t bytes = 0;
+        if (!Fcpp_impl_::storage_bytes(extents.data(), rank_, sizeof(T), bytes) ||
+            offset > std::numeric_limits<std::size_t>::max() - bytes) {
+            throw std::runtime_error(path + ": invalid array extents");
+        }
+
+        void *base = Fcpp_impl_::empty_base_addr();
+        if (bytes > 0) {
+            const int flags = (opts.mode == map_mode::read_only) ? O_RDONLY : O_RDWR;
+            Fcpp_impl_::file_handle f{::open(path.c_str(), flags)};
+            if (f.fd < 0) Fcpp_impl_::throw_errno("open " + path);
+
+            if (grow && ::ftruncate(f.fd, static_cast<off_t>(offset + bytes)) != 0) {
+                Fcpp_impl_::throw_errno("ftruncate " + path);
+            }
+            struct stat st;
+            if (::fstat(f.fd, &st) != 0) Fcpp_impl_::throw_errno("stat " + path);
+            if (static_cast<std::size_t>(st.st_size) < offset + bytes) {
+                throw std::runtime_error(path + ": file is smaller than the array");
+            }
+
+            // The offset of a mapping must be a multiple of the page size
+            const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+            const std::size_t start = offset - offset % page;
+            map_len_ = offset - start + bytes;
+
+            const int prot = (opts.mode == map_mode::read_only) ? PROT_READ : PROT_READ | PROT_WRITE;
+            const int share = (opts.mode == map_mode::copy_on_write) ? MAP_PRIVATE : MAP_SHARED;
+            void *m = ::mmap(nullptr, map_len_, prot, share, f.fd, static_cast<off_t>(start));
+            if (m == MAP_FAILED) {
+                map_len_ = 0;
+                Fcpp_impl_::throw_errno("mmap " + path);
+            }
+            map_ = m;
+
+            if (opts.hint != access_hint::normal) this->advise(opts.hint);
+#ifdef MADV_HUGEPAGE
+            // Best effort, not all file systems support it
+            if (opts.huge_pages) ::madvise(map_, map_len_, MADV_HUGEPAGE);
+#endif
+            base = static_cast<char*>(m) + (offset - start);
+            FCPP_CHECK(reinterpret_cast<std::uintptr_t>(base) % alignof(T) == 0);
+        }
+
+        [[maybe_unused]] int status = CFI_establish(this->get(), base, 
+            CFI_attribute_other, this->type(), sizeof(T), rank_, extents.data());
+        FCPP_CHECK(status == CFI_SUCCESS);
+    }
+
+    void unmap() {
+        if (map_) {
+            ::munmap(map_, map_len_);
+            map_ = nullptr;
+            map_len_ = 0;
+        }
+    }
+
+    CFI_CDESC_T(rank_) desc_;
+    void *map_{nullptr};
+    std::size_t map_len_{0};
+};
+
+/**
+ *  Write an array (cdesc, cdesc_ptr or cdesc_view) to a file with a 
+ *  header, to be mapped with mapped_array::open
+ */
+template<typename Array>
+void save_array(const std::string& path, const Array& a) {
+
+    using T = std::remove_cv_t<typename Array::value_type>;
+    constexpr int rank_ = Fcpp_impl_::array_rank<Array>::value;
+
+    const CFI_cdesc_t *desc = a.get();
+    std::array<CFI_index_t,rank_> extents;
+    std::size_t n = 1;
+    for (int d = 0; d < rank_; ++d) {
+        extents[d] = desc->dim[d].extent;
+        n *= static_cast<std::size_t>(extents[d]);
+    }
+
+    mapped_array<T,rank_> out = mapped_array<T,rank_>::create(path, extents);
+    if (n > 0) {
+        if (CFI_is_contiguous(desc) == 1) {
+            std::memcpy(out.data(), desc->base_addr, n*sizeof(T));
+        } else {
+            pack(a, out.data());
+        }
+    }
+    out.sync();
+}
+
+} // namespace Fcpp
@@ -0,0 +1,218 @@
+#pragma once
+
+// Exchange of arrays through MPI, without packing by hand
+//
+// The elements are sent straight from the array: contiguous arrays as
+// a run of elements, strided ones through a derived datatype built
+// from the byte strides, so that MPI gathers them itself.
+
+#include <complex>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <mpi.h>
+
+#include "../Fcpp.h"
+#include "pack.h"
+#include "serialize.h"
+
+namespace Fcpp {
+
+namespace Fcpp_impl_ {
+
+// Predefined datatype of an element; types without one are sent as bytes
+template<typename T>
+MPI_Datatype mpi_element_type() {
+    if constexpr (std::is_same_v<T,float>) return MPI_FLOAT;
+    else if constexpr (std::is_same_v<T,double>) return MPI_DOUBLE;
+    else if constexpr (std::is_same_v<T,long double>) return MPI_LONG_DOUBLE;
+    else if constexpr (std::is_same_v<T,std::complex<float>>) return MPI_C_FLOAT_COMPLEX;
+    else if constexpr (std::is_same_v<T,std::complex<double>>) return MPI_C_DOUBLE_COMPLEX;
+    else if constexpr (std::is_same_v<T,std::int8_t>) return MPI_INT8_T;
+    else if constexpr (std::is_same_v<T,std::int16_t>) return MPI_INT16_T;
+    else if constexpr (std::is_same_v<T,std::int32_t>) return MPI_INT32_T;
+    else if constexpr (std::is_same_v<T,std::int64_t>) return MPI_INT64_T;
+    else if constexpr (std::is_same_v<T,bool>) return MPI_C_BOOL;
+    else if constexpr (std::is_same_v<T,char>) return MPI_CHAR;
+    else return MPI_BYTE;
+}
+
+inline void check_mpi(int status, const char *what) {
+    if (status != MPI_SUCCESS) {
+        char msg[MPI_MAX_ERROR_STRING];
+        int len = 0;
+        MPI_Error_string(status,msg,&len);
+        throw std::runtime_error(std::string("Fcpp: ") + what + ": " + std::string(msg,len));
+    }
+}
+
+} // namespace Fcpp_impl_
+
+/**
+ *  Committed MPI datatype, freed on destruction (move-only)
+ */
+class mpi_datatype {
+public:
+
+    mpi_datatype() = default;
+
+    // Take ownership of a committed derived type
+    explicit mpi_datatype(MPI_Datatype t) : type_(t), owned_(true) {}
+
+    mpi_datatype(const mpi_datatype&) = delete;
+    mpi_datatype& operator=(const mpi_datatype&) = delete;
+
+    mpi_datatype(mpi_datatype&& other) noexcept
+        : type_(std::exchange(other.type_,MPI_DATATYPE_NULL)),
+          owned_(std::exchange(other.owned_,false)) {}
+
+    mpi_datatype& operator=(mpi_datatype&& other) noexcept {
+        if (this != &other) {
+            this->free();
+            type_ = std::exchange(other.type_,MPI_DATATYPE_NULL);
+            owned_ = std::exchange(other.owned_,false);
+        }
+        return *this;
+    }
+
+    ~mpi_datatype() { this->free(); }
+
+    MPI_Datatype get() const { return type_; }
+    operator MPI_Datatype() const { return type_; }
+
+private:
+
+    void free() {
+        if (owned_) MPI_Type_free(&type_);
+        owned_ = false;
+    }
+
+    MPI_Datatype type_{MPI_DATATYPE_NULL};
+    bool owned_{false};
+};
+
+/**
+ *  Datatype describing one instance of the array a, relative to its
+ *  base address, to be used with a count of 1
+ *
+ *  Dimensions that the storage allows are merged first, so that a
+ *  contiguous array or a(:,j1:j2) become a single contiguous type;
+ *  the other dimensions are stacked with MPI_Type_create_hvector using
+ *  the byte strides dim[].sm (negative strides included).
+ */
+template<typename Array>
+mpi_datatype make_datatype(const Array& a) {
+    using T = std::remove_cv_t<typename Array::value_type>;
+    constexpr int rank_ = Fcpp_impl_::array_rank<Array>::value;
+    const CFI_cdesc_t *desc = a.get();
+    FCPP_CHECK(desc->elem_len == sizeof(T));
+
+    MPI_Datatype elem = Fcpp_impl_::mpi_element_type<T>();
+    int count = 1;
+    if (elem == MPI_BYTE) count = static_cast<int>(sizeof(T));
+
+    const Fcpp_impl_::runs<rank_> r = Fcpp_impl_::coalesce<rank_>(desc);
+    if (r.size <= 0) {
+        MPI_Datatype t;
+        Fcpp_impl_::check_mpi(MPI_Type_contiguous(0,elem,&t),"MPI_Type_contiguous");
+        Fcpp_impl_::check_mpi(MPI_Type_commit(&t),"MPI_Type_commit");
+        return mpi_datatype(t);
+    }
+
+    // Innermost run: a contiguous block of elements if the stride allows
+    MPI_Datatype t;
+    if (r.sm[0] == static_cast<CFI_index_t>(sizeof(T))) {
+        Fcpp_impl_::check_mpi(MPI_Type_contiguous(
+            static_cast<int>(r.extent[0])*count,elem,&t),"MPI_Type_contiguous");
+    } else {
+        MPI_Datatype e = elem;
+        if (count > 1) Fcpp_impl_::check_mpi(MPI_Type_contiguous(count,elem,&e),"MPI_Type_contiguous");
+        Fcpp_impl_::check_mpi(MPI_Type_create_hvector(static_cast<int>(r.extent[0]),1,
+            static_cast<MPI_Aint>(r.sm[0]),e,&t),"MPI_Type_create_hvector");
+        if (count > 1) MPI_Type_free(&e);
+    }
+
+    for (int k = 1; k < r.rank; ++k) {
+        MPI_Datatype outer;
+        Fcpp_impl_::check_mpi(MPI_Type_create_hvector(static_cast<int>(r.extent[k]),1,
+            static_cast<MPI_Aint>(r.sm[k]),t,&outer),"MPI_Type_create_hvector");
+        MPI_Type_free(&t);
+        t = outer;
+    }
+
+    Fcpp_impl_::check_mpi(MPI_Type_commit(&t),"MPI_Type_commit");
+    return mpi_datatype(t);
+}
+
+/**
+ *  Send the array a: a small header with type, rank and extents
+ *  (see Fcpp/serialize.h), then the elements straight from the array,
+ *  through make_datatype(a) when it is not contiguous
+ */
+template<typename Array>
+void send(const Array& a, int dest, int tag, MPI_Comm comm) {
+    constexpr int rank_ = Fcpp_impl_::array_rank<Array>::value;
+    using T = std::remove_cv_t<typename Array::value_type>;
+    const CFI_cdesc_t *desc = a.get();
+
+    char header[Fcpp_impl_::payload_offset(rank_)];
+    serialize_header(a,header);
+    Fcpp_impl_::check_mpi(MPI_Send(header,sizeof(header),MPI_BYTE,dest,tag,comm),"MPI_Send");
+
+    if (CFI_is_contiguous(desc)) {
+        const std::size_t n = (serialized_size(a) - sizeof(header)) / sizeof(T);
+        MPI_Datatype elem = Fcpp_impl_::mpi_element_type<T>();
+        const int count = static_cast<int>(elem == MPI_BYTE ? n*sizeof(T) : n);
+        Fcpp_impl_::check_mpi(MPI_Send(desc->base_addr,count,elem,dest,tag,comm),"MPI_Send");
+    } else {
+        const mpi_datatype t = make_datatype(a);
+        Fcpp_impl_::check_mpi(MPI_Send(desc->base_addr,1,t,dest,tag,comm),"MPI_Send");
+    }
+}
+
+/**
+ *  Receive an array sent with send into out, whose type, rank and
+ *  extents must match; strided arrays are filled in place through a
+ *  derived datatype
+ */
+template<typename Array>
+void recv(const Array& out, int source, int tag, MPI_Comm comm) {
+    constexpr int rank_ = Fcpp_impl_::array_rank<Array>::value;
+    using T = std::remove_cv_t<typename Array::value_type>;
+    const CFI_cdesc_t *desc = out.get();
+
+    char header[Fcpp_impl_::payload_offset(rank_)];
+    MPI_Status status;
+    Fcpp_impl_::check_mpi(MPI_Recv(header,sizeof(header),MPI_BYTE,source,tag,comm,&status),"MPI_Recv");
+    int bytes = 0;
+    MPI_Get_count(&status,MPI_BYTE,&bytes);
+
+    const auto extents = Fcpp_impl_::read_message_header<T,rank_>(
+        header,static_cast<std::size_t>(bytes));
+    for (int d = 0; d < rank_; ++d) {
+        if (extents[d] != desc->dim[d].extent) {
+            throw std::runtime_error("Fcpp::recv: extents do not match");
+        }
+    }
+
+    // The elements follow from the same sender, also with MPI_ANY_SOURCE
+    source = status.MPI_SOURCE;
+    tag = status.MPI_TAG;
+    if (CFI_is_contiguous(desc)) {
+        std::size_t n = 1;
+        for (int d = 0; d < rank_; ++d) n *= static_cast<std::size_t>(extents[d]);
+        MPI_Datatype elem = Fcpp_impl_::mpi_element_type<T>();
+        const int count = static_cast<int>(elem == MPI_BYTE ? n*sizeof(T) : n);
+        Fcpp_impl_::check_mpi(MPI_Recv(desc->base_addr,count,elem,source,tag,comm,
+            MPI_STATUS_IGNORE),"MPI_Recv");
+    } else {
+        const mpi_datatype t = make_datatype(out);
+        Fcpp_impl_::check_mpi(MPI_Recv(desc->base_addr,1,t,source,tag,comm,
+            MPI_STATUS_IGNORE),"MPI_Recv");
+    }
+}
+
+} // namespace Fcpp
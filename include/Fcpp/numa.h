@@ -0,0 +1,200 @@
+#pragma once
+
+// NUMA-aware first-touch allocation
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <span>
+#include <thread>
+#include <vector>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#if defined(FCPP_USE_LIBNUMA)
+#include <numaif.h> // link with -lnuma
+#include <system_error>
+#include <unistd.h>
+#endif
+
+#include "../Fcpp.h"
+#include "memory.h"
+
+namespace Fcpp {
+
+/**
+ *  Partition of a loop among threads, as in the OpenMP clause 
+ *  schedule(static[,chunk])
+ *
+ *  num_threads = 0 selects the OpenMP default (omp_get_max_threads) 
+ *  when compiled with OpenMP, and the number of hardware threads 
+ *  otherwise. inner is the number of array elements per loop iteration,
+ *  e.g. the leading extent for a loop over the columns of a matrix.
+ */
+struct static_schedule {
+    int num_threads = 0;
+    std::size_t chunk = 0;
+    std::size_t inner = 1;
+};
+
+namespace Fcpp_impl_ {
+
+inline int resolve_threads(int num_threads) {
+    if (num_threads > 0) return num_threads;
+#if defined(_OPENMP)
+    return omp_get_max_threads();
+#else
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+#endif
+}
+
+// Call f(begin,end) for the iterations of thread t out of p; without a
+// chunk size the remainder goes to the first threads, as in libgomp
+template<typename F>
+void static_blocks(std::size_t n, int p, std::size_t chunk, int t, F&& f) {
+    const auto up = static_cast<std::size_t>(p);
+    const auto ut = static_cast<std::size_t>(t);
+    if (chunk == 0) {
+        const std::size_t q = n / up, r = n % up;
+        const std::size_t begin = ut*q + std::min(ut,r);
+        const std::size_t len = q + (ut < r ? 1 : 0);
+        if (len > 0) f(begin, begin + len);
+    } else {
+        for (std::size_t b = ut*chunk; b < n; b += up*chunk) {
+            f(b, std::min(b + chunk, n));
+        }
+    }
+}
+
+// Run body(t,p) on up to p threads, p being the size of the team actually
+// started; with OpenMP these are the threads of the runtime shared with
+// Fortran, placed by the same OMP_PROC_BIND and OMP_PLACES settings, and
+// the team may be smaller than requested (OMP_THREAD_LIMIT, OMP_DYNAMIC,
+// nested regions), as it is for the Fortran loops
+template<typename F>
+void parallel_threads(int p, F&& body) {
+#if defined(_OPENMP)
+    #pragma omp parallel num_threads(p)
+    body(omp_get_thread_num(), omp_get_num_threads());
+#else
+    std::vector<std::thread> threads;
+    threads.reserve(p - 1);
+    for (int t = 1; t < p; ++t) threads.emplace_back(body, t, p);
+    body(0, p);
+    for (auto& th : threads) th.join();
+#endif
+}
+
+} // namespace Fcpp_impl_
+
+/**
+ *  Allocator that leaves the elements default-initialized, so that the
+ *  pages are not touched (and placed on a NUMA node) by the allocating
+ *  thread; used with first_touch
+ */
+template<typename T, std::size_t Alignment = 4096>
+struct first_touch_allocator : aligned_allocator<T,Alignment> {
+
+    template<typename U>
+    struct rebind { using other = first_touch_allocator<U,Alignment>; };
+
+    constexpr first_touch_allocator() noexcept = default;
+
+    template<typename U>
+    constexpr first_touch_allocator(const first_touch_allocator<U,Alignment>&) noexcept {}
+
+    template<typename U>
+    void construct(U* p) noexcept(std::is_nothrow_default_constructible_v<U>) {
+        ::new (static_cast<void*>(p)) U;
+    }
+
+    template<typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+};
+
+template<typename T, std::size_t Alignment = 4096>
+using first_touch_vector = std::vector<T,first_touch_allocator<T,Alignment>>;
+
+/**
+ *  Initialize untouched storage in parallel, each thread writing the 
+ *  elements it will own in a Fortran loop with the same static schedule, 
+ *  e.g. !$omp parallel do schedule(static) over the last dimension
+ */
+template<typename T>
+void first_touch(std::span<T> data, static_schedule sched = {}, const T& value = T{}) {
+    FCPP_CHECK(sched.inner > 0 && data.size() % sched.inner == 0);
+    const std::size_t n = data.size() / sched.inner;
+    const int p = Fcpp_impl_::resolve_threads(sched.num_threads);
+    Fcpp_impl_::parallel_threads(p, [&](int t, int team) {
+        Fcpp_impl_::static_blocks(n, team, sched.chunk, t, [&](std::size_t b, std::size_t e) {
+            std::fill(data.begin() + b*sched.inner, data.begin() + e*sched.inner, value);
+        });
+    });
+}
+
+/**
+ *  Allocate n elements and initialize them with first_touch; the result
+ *  can be passed to the cdesc constructors
+ *
+ *    auto a = make_first_touch_vector<double>(nx*ny, {.inner = nx});
+ *    cdesc<double,2> fa(a.data(), nx, ny);
+ */
+template<typename T, std::size_t Alignment = 4096>
+first_touch_vector<T,Alignment> make_first_touch_vector(
+    std::size_t n, static_schedule sched = {}, const T& value = T{}) {
+    first_touch_vector<T,Alignment> v(n);
+    first_touch(std::span<T>(v), sched, value);
+    return v;
+}
+
+#if defined(FCPP_USE_LIBNUMA)
+
+namespace Fcpp_impl_ {
+
+inline void set_mempolicy_range(void *addr, std::size_t bytes, int mode, 
+                                const unsigned long *nodemask, unsigned long maxnode) {
+    // mbind requires a page-aligned start address
+    const auto page = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+    const auto a = reinterpret_cast<std::uintptr_t>(addr);
+    const std::uintptr_t start = a - a % page;
+    if (::mbind(reinterpret_cast<void*>(start), bytes + (a - start), mode, 
+                nodemask, maxnode, 0) != 0) {
+        throw std::system_error(errno, std::generic_category(), "mbind");
+    }
+}
+
+} // namespace Fcpp_impl_
+
+/**
+ *  Place not yet touched storage on one NUMA node, or interleave it 
+ *  page by page over all nodes; call before first_touch
+ */
+template<typename T>
+void numa_bind(std::span<T> data, int node) {
+    constexpr int bits = 8*sizeof(unsigned long);
+    std::vector<unsigned long> mask(node/bits + 1, 0ul);
+    mask[node/bits] = 1ul << (node % bits);
+    Fcpp_impl_::set_mempolicy_range(data.data(), data.size_bytes(), MPOL_BIND, 
+        mask.data(), mask.size()*bits);
+}
+
+template<typename T>
+void numa_interleave(std::span<T> data) {
+    // Over the nodes the process may allocate on
+    constexpr int bits = 8*sizeof(unsigned long);
+    std::vector<unsigned long> mask(1024/bits, 0ul);
+    if (::get_mempolicy(nullptr, mask.data(), mask.size()*bits, nullptr, 
+                        MPOL_F_MEMS_ALLOWED) != 0) {
+        throw std::system_error(errno, std::generic_category(), "get_mempolicy");
+    }
+    Fcpp_impl_::set_mempolicy_range(data.data(), data.size_bytes(), 
+        MPOL_INTERLEAVE, mask.data(), mask.size()*bits);
+}
+
+#endif
+
+} // namespace Fcpp
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "../Fcpp.h"
+
+namespace Fcpp {
+
+namespace Fcpp_impl_ {
+
+// Extents and byte strides of a descriptor, with adjacent dimensions 
+// merged where the storage allows it, so that a(:,j1:j2) or a whole
+// contiguous array is copied as a single run
+template<int rank_>
+struct runs {
+    int rank = 0;
+    std::array<CFI_index_t,(rank_ > 0 ? rank_ : 1)> extent{};
+    std::array<CFI_index_t,(rank_ > 0 ? rank_ : 1)> sm{};
+    CFI_index_t size = 1;
+};
+
+template<int rank_>
+runs<rank_> coalesce(const CFI_cdesc_t *desc) {
+    runs<rank_> r;
+    if constexpr (rank_ == 0) {
+        r.rank = 1;
+        r.extent[0] = 1;
+        r.sm[0] = desc->elem_len;
+        return r;
+    } else {
+        for (int d = 0; d < rank_; ++d) {
+            const CFI_index_t n = desc->dim[d].extent;
+            const CFI_index_t sm = desc->dim[d].sm;
+            r.size *= n;
+            if (r.rank > 0 && sm == r.extent[r.rank-1]*r.sm[r.rank-1]) {
+                r.extent[r.rank-1] *= n;
+            } else {
+                r.extent[r.rank] = n;
+                r.sm[r.rank] = sm;
+                ++r.rank;
+            }
+        }
+        return r;
+    }
+}
+
+// Copy between a descriptor and contiguous storage, in array element
+// order; pack_ selects the direction
+template<bool pack_, int rank_, typename T>
+CFI_index_t copy_runs(const CFI_cdesc_t *desc, T *buf) {
+
+    FCPP_CHECK(desc->elem_len == sizeof(T));
+
+    const runs<rank_> r = coalesce<rank_>(desc);
+    if (r.size <= 0) return 0;
+
+    const CFI_index_t n = r.extent[0];
+    const CFI_index_t sm = r.sm[0];
+
+    std::array<CFI_index_t,(rank_ > 0 ? rank_ : 1)> idx{};
+    char *base = static_cast<char *>(desc->base_addr);
+
+    while (true) {
+        char *row = base;
+        if constexpr (rank_ > 1) {
+            for (int d = 1; d < r.rank; ++d) row += idx[d]*r.sm[d];
+        }
+
+        if (sm == static_cast<CFI_index_t>(sizeof(T))) {
+            if constexpr (pack_) {
+                std::memcpy(buf, row, n*sizeof(T));
+            } else {
+                std::memcpy(row, buf, n*sizeof(T));
+            }
+        } else {
+            // Constant stride, left for the compiler to vectorize
+            for (CFI_index_t i = 0; i < n; ++i) {
+                T *elem = reinterpret_cast<T *>(row + i*sm);
+                if constexpr (pack_) {
+                    buf[i] = *elem;
+                } else {
+                    *elem = buf[i];
+                }
+            }
+        }
+        buf += n;
+
+        // Arrays of rank 0 or 1 are a single run
+        if constexpr (rank_ > 1) {
+            int d = 1;
+            for (; d < r.rank; ++d) {
+                if (++idx[d] < r.extent[d]) break;
+                idx[d] = 0;
+            }
+            if (d >= r.rank) break;
+        } else {
+            break;
+        }
+    }
+    return r.size;
+}
+
+} // namespace Fcpp_impl_
+
+/**
+ *  Copy the elements of an array (cdesc, cdesc_ptr or cdesc_view) 
+ *  into contiguous storage, in array element order
+ *
+ *  Returns the number of elements copied.
+ */
+template<typename Array>
+std::size_t pack(const Array& a, std::remove_cv_t<typename Array::value_type> *dst) {
+    constexpr int rank_ = Fcpp_impl_::array_rank<Array>::value;
+    return Fcpp_impl_::copy_runs<true,rank_>(a.get(),dst);
+}
+
+/**
+ *  Copy contiguous storage back into the elements of an array,
+ *  the inverse of pack()
+ */
+template<typename Array>
+std::size_t unpack(const typename Array::value_type *src, const Array& a) {
+    constexpr int rank_ = Fcpp_impl_::array_rank<Array>::value;
+    return Fcpp_impl_::copy_runs<false,rank_>(a.get(),
+        const_cast<typename Array::value_type *>(src));
+}
+
+enum class copy_back : bool { no = false, yes = true };
+
+/**
+ *  Contiguous copy of an array, staged in a caller-provided scratch 
+ *  buffer (Fortran copy-in/copy-out)
+ *
+ *  Contiguous arrays are used in place. Otherwise, the elements are 
+ *  packed into scratch, which only grows, so that reusing it keeps 
+ *  the hot path free of allocations; with copy_back::yes they are
+ *  unpacked into the array when the object goes out of scope.
+ */
+template<typename T, int rank_>
+class staged {
+public:
+
+    using view_type = cdesc_ptr<T,rank_,attr::other,layout::contiguous>;
+
+    template<typename Array, typename Alloc>
+    staged(const Array& a, std::vector<T,Alloc>& scratch, 
+           copy_back cb = copy_back::yes) : copy_back_(cb) {
+
+        static_assert(Fcpp_impl_::array_rank<Array>::value == rank_);
+
+        // Copy the descriptor, a may be a temporary section
+        std::memcpy(&source_, a.get(), sizeof(source_));
+        FCPP_CHECK(source_.base_addr);
+
+        std::array<CFI_index_t,(rank_ > 0 ? rank_ : 1)> ext{};
+        std::size_t n = 1;
+        for (int d = 0; d < rank_; ++d) {
+            ext[d] = source_.dim[d].extent;
+            n *= ext[d];
+        }
+
+        T *ptr = static_cast<T *>(source_.base_addr);
+        if (n > 0 && CFI_is_contiguous((CFI_cdesc_t *) &source_) != 1) {
+            if (scratch.size() < n) scratch.resize(n);
+            ptr = scratch.data();
+            pack(a,ptr);
+            copied_ = true;
+        }
+
+        [[maybe_unused]] int status = CFI_establish((CFI_cdesc_t *) &desc_, ptr, 
+            CFI_attribute_other, source_.type, source_.elem_len, rank_, ext.data());
+        FCPP_CHECK(status == CFI_SUCCESS);
+    }
+
+    staged(const staged&) = delete;
+    staged& operator=(const staged&) = delete;
+
+    ~staged() { 
+        if (copied_ && copy_back_ == copy_back::yes) {
+            Fcpp_impl_::copy_runs<false,rank_>((CFI_cdesc_t *) &source_,data());
+        }
+    }
+
+    // True if the elements were copied into the scratch buffer
+    bool is_copy() const { return copied_; }
+
+    T* data() const { return static_cast<T *>(desc_.base_addr); }
+
+    CFI_cdesc_t* get() const { return (CFI_cdesc_t *) &desc_; }
+    operator CFI_cdesc_t*() const { return get(); }
+
+    view_type view() const { return view_type(get()); }
+
+private:
+    CFI_CDESC_T(rank_) source_;
+    CFI_CDESC_T(rank_) desc_;
+    bool copied_{false};
+    copy_back copy_back_;
+};
+
+template<typename Array, typename Alloc>
+staged(const Array&, std::vector<typename Array::value_type,Alloc>&, copy_back = copy_back::yes) 
+    -> staged<typename Array::value_type,Fcpp_impl_::array_rank<Array>::value>;
+
+} // namespace Fcpp
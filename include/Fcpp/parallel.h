@@ -0,0 +1,412 @@
+#pragma once
+
+// Parallel loops over Fortran arrays
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include "../Fcpp.h"
+#include "algorithms.h"
+
+#ifndef FCPP_CACHE_LINE_BYTES
+#define FCPP_CACHE_LINE_BYTES 64
+#endif
+
+// Default amount of data per chunk of a parallel loop
+#ifndef FCPP_PARALLEL_CHUNK_BYTES
+#define FCPP_PARALLEL_CHUNK_BYTES 65536
+#endif
+
+namespace Fcpp {
+
+/**
+ *  Pool of worker threads running loops of independent tasks, with
+ *  work stealing
+ *
+ *  The tasks of a loop are first split into one contiguous block per
+ *  thread (as with a static schedule, which keeps the placement of a
+ *  first-touch allocation); a thread that runs out of work takes the
+ *  second half of the remaining block of another thread. The calling
+ *  thread takes part, and loops started from within a task run
+ *  sequentially in that task.
+ */
+class thread_pool {
+public:
+
+    // num_threads includes the calling thread; 0 selects the number
+    // of hardware threads
+    explicit thread_pool(unsigned num_threads = 0) {
+        if (num_threads == 0) num_threads = std::max(1u, std::thread::hardware_concurrency());
+        blocks_ = std::make_unique<block[]>(num_threads);
+        size_ = num_threads;
+        workers_.reserve(num_threads - 1);
+        for (unsigned t = 1; t < num_threads; ++t) {
+            workers_.emplace_back([this,t] { this->work(t); });
+        }
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    ~thread_pool() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        start_.notify_all();
+        for (auto& w : workers_) w.join();
+    }
+
+    // Number of threads, including the calling thread
+    unsigned size() const { return size_; }
+
+    // Pool shared by the loops without an explicit executor
+    static thread_pool& global() {
+        static thread_pool pool;
+        return pool;
+    }
+
+    // Call g(i) for i in [0,n) and wait for completion; the first
+    // exception thrown by a task is rethrown here
+    template<typename G>
+    void operator()(std::size_t n, G&& g) {
+        if (n == 0) return;
+        if (size_ == 1 || n == 1 || in_task()) {
+            for (std::size_t i = 0; i < n; ++i) g(i);
+            return;
+        }
+
+        std::lock_guard loop(loop_mutex_);   // one loop at a time
+        task_ = [](void *ctx, std::size_t i) { (*static_cast<std::remove_reference_t<G>*>(ctx))(i); };
+        ctx_ = const_cast<void*>(static_cast<const void*>(std::addressof(g)));
+        error_ = nullptr;
+
+        for (unsigned t = 0; t < size_; ++t) {
+            std::lock_guard lock(blocks_[t].mutex);
+            blocks_[t].begin = n*t/size_;
+            blocks_[t].end = n*(t + 1)/size_;
+        }
+        {
+            std::lock_guard lock(mutex_);
+            busy_ = size_ - 1;
+            ++generation_;
+        }
+        start_.notify_all();
+
+        this->run(0);
+
+        std::unique_lock lock(mutex_);
+        done_.wait(lock, [this] { return busy_ == 0; });
+        if (error_) std::rethrow_exception(error_);
+    }
+
+private:
+
+    // Remaining tasks [begin,end) of one thread
+    struct alignas(FCPP_CACHE_LINE_BYTES) block {
+        std::mutex mutex;
+        std::size_t begin = 0;
+        std::size_t end = 0;
+    };
+
+    static bool& in_task() {
+        thread_local bool flag = false;
+        return flag;
+    }
+
+    // Next task of thread t, from its own block or stolen
+    std::optional<std::size_t> next(unsigned t) {
+        {
+            block& own = blocks_[t];
+            std::lock_guard lock(own.mutex);
+            if (own.begin < own.end) return own.begin++;
+        }
+        for (unsigned k = 1; k < size_; ++k) {
+            block& victim = blocks_[(t + k) % size_];
+            std::size_t begin, end;
+            {
+                std::lock_guard lock(victim.mutex);
+                if (victim.begin >= victim.end) continue;
+                end = victim.end;
+                begin = victim.begin + (victim.end - victim.begin)/2;
+                victim.end = begin;
+            }
+            std::lock_guard lock(blocks_[t].mutex);
+            blocks_[t].begin = begin + 1;
+            blocks_[t].end = end;
+            return begin;
+        }
+        return std::nullopt;
+    }
+
+    void run(unsigned t) {
+        in_task() = true;
+        while (auto i = this->next(t)) {
+            try {
+                task_(ctx_, *i);
+            } catch (...) {
+                std::lock_guard lock(mutex_);
+                if (!error_) error_ = std::current_exception();
+            }
+        }
+        in_task() = false;
+    }
+
+    void work(unsigned t) {
+        std::size_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock lock(mutex_);
+                start_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_) return;
+                seen = generation_;
+            }
+            this->run(t);
+            {
+                std::lock_guard lock(mutex_);
+                --busy_;
+            }
+            done_.notify_one();
+        }
+    }
+
+    unsigned size_;
+    std::unique_ptr<block[]> blocks_;
+    std::vector<std::thread> workers_;
+
+    std::mutex loop_mutex_;
+    std::mutex mutex_;
+    std::condition_variable start_, done_;
+    std::size_t generation_{0};
+    unsigned busy_{0};
+    bool stop_{false};
+
+    void (*task_)(void*, std::size_t){nullptr};
+    void *ctx_{nullptr};
+    std::exception_ptr error_;
+};
+
+// Runs the tasks in order on the calling thread
+struct sequential_executor {
+    template<typename G>
+    void operator()(std::size_t n, G&& g) const {
+        for (std::size_t i = 0; i < n; ++i) g(i);
+    }
+};
+
+#if defined(_OPENMP)
+// Runs the tasks on the OpenMP threads shared with Fortran
+struct openmp_executor {
+    template<typename G>
+    void operator()(std::size_t n, G&& g) const {
+        std::exception_ptr error;
+        #pragma omp parallel for schedule(dynamic,1)
+        for (std::size_t i = 0; i < n; ++i) {
+            try {
+                g(i);
+            } catch (...) {
+                #pragma omp critical(fcpp_openmp_executor)
+                if (!error) error = std::current_exception();
+            }
+        }
+        if (error) std::rethrow_exception(error);
+    }
+};
+#endif
+
+// Chunk size of a parallel loop in elements; 0 selects
+// FCPP_PARALLEL_CHUNK_BYTES
+struct parallel_options {
+    std::size_t grain = 0;
+};
+
+namespace Fcpp_impl_ {
+
+// Executors run ex(n, g), calling g(i) once for each i in [0,n),
+// e.g. [](std::size_t n, auto&& g) { tbb::parallel_for(std::size_t(0), n, g); }
+template<typename E>
+concept executor = requires (E& ex, void (*g)(std::size_t)) { ex(std::size_t{1}, g); };
+
+// Array elements in column-major order, split into chunks [bounds[k],
+// bounds[k+1]) whose boundaries never fall inside a cache line
+template<int rank_>
+struct chunk_plan {
+    joint_runs<rank_,1> runs;
+    std::vector<CFI_index_t> bounds;
+
+    // Element offset (in elements) of linear index p
+    CFI_index_t offset(CFI_index_t p) const {
+        CFI_index_t off = 0;
+        for (int d = 0; d < runs.rank; ++d) {
+            off += (p % runs.extent[d])*runs.inc[d][0];
+            p /= runs.extent[d];
+        }
+        return off;
+    }
+};
+
+template<int rank_>
+chunk_plan<rank_> plan_chunks(const CFI_cdesc_t *desc, std::size_t grain) {
+    chunk_plan<rank_> plan;
+    plan.bounds.push_back(0);
+    if (!desc->base_addr) return plan;
+    plan.runs = coalesce_joint<rank_,1>({desc});
+    const CFI_index_t size = plan.runs.size;
+    if (size <= 0) return plan;
+
+    const std::size_t elem = desc->elem_len;
+    if (grain == 0) grain = std::max<std::size_t>(1, FCPP_PARALLEL_CHUNK_BYTES / elem);
+    const auto base = reinterpret_cast<std::uintptr_t>(desc->base_addr);
+    auto lines = [&](CFI_index_t p) {
+        const std::uintptr_t a = base + static_cast<std::uintptr_t>(plan.offset(p)*static_cast<CFI_index_t>(elem));
+        return std::pair{a / FCPP_CACHE_LINE_BYTES, (a + elem - 1) / FCPP_CACHE_LINE_BYTES};
+    };
+    // A chunk may start at p if elements p-1 and p share no cache line
+    auto separate = [&](CFI_index_t p) {
+        const auto [lo0,hi0] = lines(p - 1);
+        const auto [lo1,hi1] = lines(p);
+        return hi0 < lo1 || hi1 < lo0;
+    };
+
+    for (CFI_index_t p = static_cast<CFI_index_t>(grain); p < size; ) {
+        while (p < size && !separate(p)) ++p;
+        if (p >= size) break;
+        plan.bounds.push_back(p);
+        p += static_cast<CFI_index_t>(grain);
+    }
+    plan.bounds.push_back(size);
+    return plan;
+}
+
+// Call f(ptr, n, inc) for the runs of elements [b,e) of a chunk
+template<typename T, int rank_, typename F>
+void for_each_chunk_run(T *base, const chunk_plan<rank_>& plan, CFI_index_t b, CFI_index_t e, F&& f) {
+    const auto& r = plan.runs;
+    constexpr int max_rank = joint_runs<rank_,1>::max_rank;
+    std::array<CFI_index_t,max_rank> idx{};
+    CFI_index_t p = b;
+    for (int d = 0; d < r.rank; ++d) {
+        idx[d] = p % r.extent[d];
+        p /= r.extent[d];
+    }
+    // Start of the current run
+    T *row = base + (plan.offset(b) - idx[0]*r.inc[0][0]);
+    CFI_index_t left = e - b;
+    while (left > 0) {
+        const CFI_index_t n = std::min(left, r.extent[0] - idx[0]);
+        f(row + idx[0]*r.inc[0][0], n, r.inc[0][0]);
+        left -= n;
+        if (left == 0) break;
+
+        idx[0] = 0;
+        // A single run has nothing to carry into
+        if constexpr (max_rank > 1) {
+            for (int d = 1; d < r.rank; ++d) {
+                row += r.inc[d][0];
+                if (++idx[d] < r.extent[d]) break;
+                row -= r.extent[d]*r.inc[d][0];
+                idx[d] = 0;
+            }
+        }
+    }
+}
+
+} // namespace Fcpp_impl_
+
+/**
+ *  Call f(x) for each element x of an array of any rank (cdesc,
+ *  cdesc_ptr or cdesc_view, contiguous or strided), in parallel
+ *
+ *  The elements are split in column-major order into chunks of about
+ *  FCPP_PARALLEL_CHUNK_BYTES, whose boundaries never fall inside a
+ *  cache line, so that threads writing neighbouring chunks do not
+ *  share lines (for arrays with non-decreasing or non-increasing
+ *  addresses in element order, which includes sections with steps of
+ *  the same sign). The chunks are run by the executor ex, by default
+ *  the global thread_pool.
+ */
+template<typename Executor, typename Array, typename F>
+    requires Fcpp_impl_::executor<Executor> && Fcpp_impl_::array_operand<Array>
+void parallel_for(Executor&& ex, const Array& a, F f, parallel_options opts = {}) {
+    using T = typename Array::value_type;
+    constexpr int rank_ = Fcpp_impl_::array_rank<Array>::value;
+
+    const auto plan = Fcpp_impl_::plan_chunks<rank_>(a.get(), opts.grain);
+    if (plan.bounds.size() < 2) return;
+    T *base = Fcpp_impl_::base<T>(a);
+
+    ex(plan.bounds.size() - 1, [&](std::size_t k) {
+        Fcpp_impl_::for_each_chunk_run(base, plan, plan.bounds[k], plan.bounds[k+1],
+            [&](T *p, CFI_index_t n, CFI_index_t inc) {
+                if (inc == 1) {
+                    for (CFI_index_t i = 0; i < n; ++i) f(p[i]);
+                } else {
+                    for (CFI_index_t i = 0; i < n; ++i) f(p[i*inc]);
+                }
+            });
+    });
+}
+
+template<typename Array, typename F>
+    requires Fcpp_impl_::array_operand<Array>
+void parallel_for(const Array& a, F f, parallel_options opts = {}) {
+    parallel_for(thread_pool::global(), a, std::move(f), opts);
+}
+
+/**
+ *  Reduce the elements of an array with op, in parallel, starting from
+ *  init: op(...op(op(init, r0), r1)..., rk) with the partial result ri of
+ *  chunk i computed in element order
+ *
+ *  op must be associative; the chunks, and hence the result, do not
+ *  depend on the number of threads or the executor.
+ */
+template<typename Executor, typename Array, typename T, typename Op>
+    requires Fcpp_impl_::executor<Executor> && Fcpp_impl_::array_operand<Array>
+T parallel_reduce(Executor&& ex, const Array& a, T init, Op op, parallel_options opts = {}) {
+    using V = typename Array::value_type;
+    constexpr int rank_ = Fcpp_impl_::array_rank<Array>::value;
+
+    const auto plan = Fcpp_impl_::plan_chunks<rank_>(a.get(), opts.grain);
+    if (plan.bounds.size() < 2) return init;
+    const std::size_t nchunks = plan.bounds.size() - 1;
+    V *base = Fcpp_impl_::base<V>(a);
+
+    // One partial result per cache line
+    struct alignas(FCPP_CACHE_LINE_BYTES) partial { std::optional<T> value; };
+    std::vector<partial> partials(nchunks);
+
+    ex(nchunks, [&](std::size_t k) {
+        std::optional<T> acc;
+        Fcpp_impl_::for_each_chunk_run(base, plan, plan.bounds[k], plan.bounds[k+1],
+            [&](V *p, CFI_index_t n, CFI_index_t inc) {
+                CFI_index_t i = 0;
+                if (!acc) acc.emplace(p[i++]);
+                for (; i < n; ++i) *acc = op(std::move(*acc), p[i*inc]);
+            });
+        partials[k].value = std::move(acc);
+    });
+
+    for (auto& r : partials) init = op(std::move(init), std::move(*r.value));
+    return init;
+}
+
+template<typename Array, typename T, typename Op>
+    requires Fcpp_impl_::array_operand<Array>
+T parallel_reduce(const Array& a, T init, Op op, parallel_options opts = {}) {
+    return parallel_reduce(thread_pool::global(), a, std::move(init), std::move(op), opts);
+}
+
+} // namespace Fcpp
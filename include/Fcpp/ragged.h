@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#include "../Fcpp.h"
+
+namespace Fcpp {
+
+/**
+ *  Array of rows of varying length in compressed sparse row (CSR) 
+ *  storage: the values of all rows in one vector, and the zero-based 
+ *  offsets of the rows, with offsets[i+1] - offsets[i] the length of 
+ *  row i
+ *
+ *  Rows are available as zero-copy descriptors, and the values and 
+ *  offsets as rank-1 descriptors. In Fortran, with one-based indices,
+ *  row i is values(offsets(i)+1:offsets(i+1)).
+ */
+template<typename T, typename Index = int, typename Allocator = std::allocator<T>>
+class ragged_array {
+public:
+
+    static_assert(std::is_integral_v<Index> && std::is_signed_v<Index>,
+        "Offsets must be of signed integer type (Fortran has no unsigned integers)");
+
+    using value_type = T;
+    using index_type = Index;
+    using size_type = std::size_t;
+    using allocator_type = Allocator;
+
+    using row_type = std::span<T>;
+    using const_row_type = std::span<const T>;
+
+    ragged_array() : offsets_{0} {}
+
+    explicit ragged_array(const Allocator& alloc) : values_(alloc), offsets_{0} {}
+
+    // Construct from a range of ranges, e.g. std::vector<std::vector<T>>
+    template<std::ranges::input_range R>
+        requires std::ranges::input_range<std::ranges::range_reference_t<R>>
+    explicit ragged_array(R&& rows, const Allocator& alloc = Allocator()) 
+        : ragged_array(alloc) {
+        if constexpr (std::ranges::sized_range<R>) {
+            offsets_.reserve(std::ranges::size(rows) + 1);
+        }
+        for (auto&& row : rows) this->push_back(row);
+    }
+
+    // Take ownership of existing CSR arrays
+    ragged_array(std::vector<T,Allocator> values, std::vector<Index> offsets) 
+        : values_(std::move(values)), offsets_(std::move(offsets)) {
+        FCPP_CHECK(!offsets_.empty() && offsets_.front() == 0);
+        FCPP_CHECK(static_cast<size_type>(offsets_.back()) == values_.size());
+    }
+
+    // Append a row
+    template<std::ranges::input_range R>
+    void push_back(R&& row) {
+        values_.insert(values_.end(),std::ranges::begin(row),std::ranges::end(row));
+        offsets_.push_back(static_cast<Index>(values_.size()));
+    }
+
+    void push_back(std::initializer_list<T> row) {
+        this->push_back(std::span<const T>(row.begin(),row.size()));
+    }
+
+    void reserve(size_type rows, size_type values) {
+        offsets_.reserve(rows + 1);
+        values_.reserve(values);
+    }
+
+    void clear() {
+        values_.clear();
+        offsets_.resize(1);
+    }
+
+    // Number of rows
+    size_type size() const { return offsets_.size() - 1; }
+    bool empty() const { return this->size() == 0; }
+
+    // Total number of values
+    size_type num_values() const { return values_.size(); }
+
+    size_type row_size(size_type i) const {
+        FCPP_CHECK_BOUNDS(i < this->size());
+        return static_cast<size_type>(offsets_[i+1] - offsets_[i]);
+    }
+
+    row_type operator[](size_type i) {
+        return row_type(values_.data() + offsets_[i], this->row_size(i));
+    }
+    const_row_type operator[](size_type i) const {
+        return const_row_type(values_.data() + offsets_[i], this->row_size(i));
+    }
+
+    // Descriptor of row i, referring to the values in place
+    cdesc<T> row(size_type i) {
+        return cdesc<T>(this->values_data() + offsets_[i], 
+            static_cast<int>(this->row_size(i)));
+    }
+
+    // Descriptors of the CSR arrays
+    cdesc<T> values() { 
+        return cdesc<T>(this->values_data(), static_cast<int>(values_.size())); 
+    }
+    cdesc<Index> offsets() { 
+        return cdesc<Index>(offsets_.data(), static_cast<int>(offsets_.size())); 
+    }
+
+    std::vector<T,Allocator>& values_vector() { return values_; }
+    const std::vector<T,Allocator>& values_vector() const { return values_; }
+    const std::vector<Index>& offsets_vector() const { return offsets_; }
+
+    // Iteration over the rows
+    auto rows() {
+        return std::views::iota(size_type{0},this->size()) | 
+            std::views::transform([this](size_type i) { return (*this)[i]; });
+    }
+    auto rows() const {
+        return std::views::iota(size_type{0},this->size()) | 
+            std::views::transform([this](size_type i) { return (*this)[i]; });
+    }
+
+private:
+
+    T* values_data() {
+        return values_.empty() ? static_cast<T*>(Fcpp_impl_::empty_base_addr()) 
+                               : values_.data();
+    }
+
+    std::vector<T,Allocator> values_;
+    std::vector<Index> offsets_;
+};
+
+template<std::ranges::input_range R>
+ragged_array(R&&) -> ragged_array<
+    std::ranges::range_value_t<std::ranges::range_reference_t<R>>>;
+
+} // namespace Fcpp
@@ -0,0 +1,308 @@
+#pragma once
+
+// Serialized form of arrays, for exchange through messages or
+// shared-memory segments between processes (POSIX)
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../Fcpp.h"
+#include "pack.h"
+
+namespace Fcpp {
+
+/**
+ *  Header of a serialized array, followed by the elements packed in
+ *  array element order (column-major) at payload_offset(rank), so that
+ *  the strides of the payload follow from the extents. Only rank extents
+ *  are stored. Fields are in native byte order.
+ */
+struct array_message_header {
+    char magic[8];              // "FCPPMSG1"
+    std::int32_t type;          // CFI type code
+    std::int32_t elem_len;
+    std::int32_t rank;
+    std::int32_t reserved;
+    // std::int64_t extent[rank] follows
+};
+
+namespace Fcpp_impl_ {
+
+inline constexpr char array_message_magic[8] = {'F','C','P','P','M','S','G','1'};
+
+// Elements start at a multiple of 16 bytes, enough for any interoperable type
+inline constexpr std::size_t payload_offset(int rank) {
+    const std::size_t n = sizeof(array_message_header) + rank*sizeof(std::int64_t);
+    return (n + 15) / 16 * 16;
+}
+
+template<typename T, int rank_>
+void check_message(const array_message_header& h) {
+    if (std::memcmp(h.magic, array_message_magic, sizeof(h.magic)) != 0) {
+        throw std::runtime_error("Fcpp::deserialize: not a serialized array");
+    }
+    if (h.rank != rank_) {
+        throw std::runtime_error("Fcpp::deserialize: rank " + std::to_string(h.rank) +
+            " does not match " + std::to_string(rank_));
+    }
+    if (h.type != type<T>() || h.elem_len != static_cast<std::int32_t>(sizeof(T))) {
+        throw std::runtime_error("Fcpp::deserialize: element type does not match");
+    }
+}
+
+// Extents of a serialized array, from its header alone
+template<typename T, int rank_>
+std::array<CFI_index_t,rank_> read_message_header(const void *buf, std::size_t bytes) {
+    if (bytes < payload_offset(rank_)) {
+        throw std::runtime_error("Fcpp::deserialize: truncated header");
+    }
+    array_message_header h;
+    std::memcpy(&h, buf, sizeof(h));
+    check_message<T,rank_>(h);
+
+    std::array<CFI_index_t,rank_> extents;
+    const char *p = static_cast<const char *>(buf) + sizeof(h);
+    for (int d = 0; d < rank_; ++d) {
+        std::int64_t e;
+        std::memcpy(&e, p + d*sizeof(e), sizeof(e));
+        if (e < 0) throw std::runtime_error("Fcpp::deserialize: negative extent");
+        extents[d] = static_cast<CFI_index_t>(e);
+    }
+    return extents;
+}
+
+} // namespace Fcpp_impl_
+
+/**
+ *  Extents of a serialized array of bytes bytes, checking the
+ *  header and that the payload is complete
+ */
+template<typename T, int rank_>
+std::array<CFI_index_t,rank_> serialized_extents(const void *buf, std::size_t bytes) {
+    const auto extents = Fcpp_impl_::read_message_header<T,rank_>(buf, bytes);
+    std::size_t n = 0;
+    if (!Fcpp_impl_::storage_bytes(extents.data(), rank_, sizeof(T), n)) {
+        throw std::runtime_error("Fcpp::deserialize: invalid extents");
+    }
+    if (bytes - Fcpp_impl_::payload_offset(rank_) < n) {
+        throw std::runtime_error("Fcpp::deserialize: truncated payload");
+    }
+    return extents;
+}
+
+/**
+ *  Bytes taken by the serialized form of an array
+ */
+template<typename Array>
+std::size_t serialized_size(const Array& a) {
+    using T = std::remove_cv_t<typename Array::value_type>;
+    constexpr int rank_ = Fcpp_impl_::array_rank<Array>::value;
+    std::size_t n = 1;
+    for (int d = 0; d < rank_; ++d) n *= static_cast<std::size_t>(a.get()->dim[d].extent);
+    return Fcpp_impl_::payload_offset(rank_) + n*sizeof(T);
+}
+
+/**
+ *  Write the header of the serialized form of an array to buf, which
+ *  must hold payload_offset(rank) bytes; the elements can then be sent
+ *  separately, straight from a contiguous array
+ */
+template<typename Array>
+std::size_t serialize_header(const Array& a, void *buf) {
+    using T = std::remove_cv_t<typename Array::value_type>;
+    constexpr int rank_ = Fcpp_impl_::array_rank<Array>::value;
+    const CFI_cdesc_t *desc = a.get();
+
+    array_message_header h{};
+    std::memcpy(h.magic, Fcpp_impl_::array_message_magic, sizeof(h.magic));
+    h.type = Fcpp_impl_::type<T>();
+    h.rank = rank_;
+    h.elem_len = sizeof(T);
+
+    char *p = static_cast<char *>(buf);
+    std::memcpy(p, &h, sizeof(h));
+    for (int d = 0; d < rank_; ++d) {
+        const std::int64_t e = desc->dim[d].extent;
+        std::memcpy(p + sizeof(h) + d*sizeof(e), &e, sizeof(e));
+    }
+    const std::size_t offset = Fcpp_impl_::payload_offset(rank_);
+    std::memset(p + sizeof(h) + rank_*sizeof(std::int64_t), 0,
+        offset - sizeof(h) - rank_*sizeof(std::int64_t));
+    return offset;
+}
+
+/**
+ *  Serialize an array (cdesc, cdesc_ptr, cdesc_view) into buf, which
+ *  must hold serialized_size(a) bytes; returns the number of bytes written
+ */
+template<typename Array>
+std::size_t serialize(const Array& a, void *buf) {
+    using T = std::remove_cv_t<typename Array::value_type>;
+    const std::size_t offset = serialize_header(a, buf);
+    T *payload = reinterpret_cast<T *>(static_cast<char *>(buf) + offset);
+    return offset + pack(a, payload)*sizeof(T);
+}
+
+template<typename Array>
+std::vector<std::byte> serialize(const Array& a) {
+    std::vector<std::byte> buf(serialized_size(a));
+    serialize(a, buf.data());
+    return buf;
+}
+
+/**
+ *  Copy the elements of a serialized array into out, whose type, rank
+ *  and extents must match
+ */
+template<typename Array>
+void deserialize(const void *buf, std::size_t bytes, const Array& out) {
+    using T = std::remove_cv_t<typename Array::value_type>;
+    constexpr int rank_ = Fcpp_impl_::array_rank<Array>::value;
+    const auto extents = serialized_extents<T,rank_>(buf, bytes);
+    for (int d = 0; d < rank_; ++d) {
+        if (extents[d] != out.get()->dim[d].extent) {
+            throw std::runtime_error("Fcpp::deserialize: extents do not match");
+        }
+    }
+    const T *payload = reinterpret_cast<const T *>(
+        static_cast<const char *>(buf) + Fcpp_impl_::payload_offset(rank_));
+    unpack(payload, out);
+}
+
+/**
+ *  Zero-copy view of the elements of a serialized array,
+ *  valid as long as buf is
+ */
+template<typename T, int rank_>
+cdesc<const T,rank_> serialized_view(const void *buf, std::size_t bytes) {
+    static_assert(rank_ > 0, "Views of serialized scalars are not supported");
+    const auto extents = serialized_extents<T,rank_>(buf, bytes);
+    for (int d = 0; d < rank_; ++d) {
+        if (extents[d] > std::numeric_limits<int>::max()) {
+            throw std::runtime_error("Fcpp::serialized_view: extent " + 
+                std::to_string(extents[d]) + " does not fit in int");
+        }
+    }
+    const T *payload = reinterpret_cast<const T *>(
+        static_cast<const char *>(buf) + Fcpp_impl_::payload_offset(rank_));
+    return [&]<std::size_t... d>(std::index_sequence<d...>) {
+        return cdesc<const T,rank_>(payload, static_cast<int>(extents[d])...);
+    }(std::make_index_sequence<rank_>{});
+}
+
+/**
+ *  POSIX shared-memory segment (shm_open), e.g. holding serialized
+ *  arrays exchanged between the processes of a node
+ */
+class shared_segment {
+public:
+
+    // Create a segment of the given size; fails if the name exists
+    static shared_segment create(const std::string& name, std::size_t bytes) {
+        const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) throw_errno("shm_open " + name);
+        if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            const int err = errno;
+            ::close(fd);
+            ::shm_unlink(name.c_str());
+            throw std::system_error(err, std::generic_category(), "ftruncate " + name);
+        }
+        return shared_segment(fd, bytes, true, name);
+    }
+
+    // Map an existing segment, read-only unless writable is set
+    static shared_segment open(const std::string& name, bool writable = false) {
+        const int fd = ::shm_open(name.c_str(), writable ? O_RDWR : O_RDONLY, 0);
+        if (fd < 0) throw_errno("shm_open " + name);
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            const int err = errno;
+            ::close(fd);
+            throw std::system_error(err, std::generic_category(), "fstat " + name);
+        }
+        return shared_segment(fd, static_cast<std::size_t>(st.st_size), writable, name);
+    }
+
+    // Remove the name; mappings stay valid until they are unmapped
+    static void unlink(const std::string& name) { ::shm_unlink(name.c_str()); }
+
+    shared_segment(const shared_segment&) = delete;
+    shared_segment& operator=(const shared_segment&) = delete;
+
+    shared_segment(shared_segment&& other) noexcept
+        : name_(std::move(other.name_)),
+          data_(std::exchange(other.data_,nullptr)),
+          size_(std::exchange(other.size_,0)) {}
+
+    shared_segment& operator=(shared_segment&& other) noexcept {
+        if (this != &other) {
+            this->unmap();
+            name_ = std::move(other.name_);
+            data_ = std::exchange(other.data_,nullptr);
+            size_ = std::exchange(other.size_,0);
+        }
+        return *this;
+    }
+
+    ~shared_segment() { this->unmap(); }
+
+    void *data() const { return data_; }
+    std::size_t size() const { return size_; }
+    const std::string& name() const { return name_; }
+
+private:
+
+    shared_segment(int fd, std::size_t bytes, bool writable, const std::string& name)
+        : name_(name), size_(bytes) {
+        if (bytes > 0) {
+            void *m = ::mmap(nullptr, bytes, PROT_READ | (writable ? PROT_WRITE : 0),
+                             MAP_SHARED, fd, 0);
+            const int err = errno;
+            ::close(fd);
+            if (m == MAP_FAILED) throw std::system_error(err, std::generic_category(), "mmap " + name);
+            data_ = m;
+        } else {
+            ::close(fd);
+        }
+    }
+
+    [[noreturn]] static void throw_errno(const std::string& what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    void unmap() {
+        if (data_) ::munmap(data_, size_);
+        data_ = nullptr;
+    }
+
+    std::string name_;
+    void *data_{nullptr};
+    std::size_t size_{0};
+};
+
+/**
+ *  Serialize an array into a new shared-memory segment, which other
+ *  processes open with shared_segment::open and read with
+ *  serialized_view or deserialize
+ */
+template<typename Array>
+shared_segment publish(const std::string& name, const Array& a) {
+    shared_segment s = shared_segment::create(name, serialized_size(a));
+    serialize(a, s.data());
+    return s;
+}
+
+} // namespace Fcpp
@@ -0,0 +1,450 @@
+#pragma once
+
+// Chunked streaming of arrays to and from files (POSIX), with the I/O
+// of the next chunk overlapped with the computation on the current one
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/uio.h>
+#include <climits>
+
+#include "../Fcpp.h"
+#include "memory.h"
+#include "mmap.h"
+#include "pack.h"
+
+namespace Fcpp {
+
+namespace Fcpp_impl_ {
+
+// Read or write exactly n bytes at offset, retrying short transfers
+template<bool read_>
+void transfer(int fd, char *buf, std::size_t n, off_t offset, const char *what) {
+    while (n > 0) {
+        const ssize_t k = read_ ? ::pread(fd, buf, n, offset) : ::pwrite(fd, buf, n, offset);
+        if (k < 0) {
+            if (errno == EINTR) continue;
+            throw_errno(what);
+        }
+        if (k == 0) throw std::runtime_error(std::string(what) + ": unexpected end of file");
+        buf += k;
+        n -= static_cast<std::size_t>(k);
+        offset += k;
+    }
+}
+
+} // namespace Fcpp_impl_
+
+struct stream_options {
+    // Number of rotating buffers (chunks in flight)
+    std::size_t buffers = 2;
+    // Lock the buffers in memory (mlock), where permitted
+    bool lock_memory = false;
+};
+
+/**
+ *  Chunk of an array read by chunked_reader: the slab of indices 
+ *  [first(), first() + extent(rank-1)) along the last dimension
+ */
+template<typename T, int rank_>
+class stream_chunk {
+public:
+
+    using view_type = cdesc_ptr<T,rank_,attr::other,layout::contiguous>;
+
+    // Return pointer to the underlying descriptor
+    constexpr auto get() const { return (CFI_cdesc_t *) &desc_; }
+
+    // Implicit cast to C-descriptor pointer
+    operator CFI_cdesc_t* () const { return this->get(); }
+
+    view_type view() const { return view_type(this->get()); }
+
+    // Zero-based index of the chunk along the last dimension
+    std::size_t first() const { return first_; }
+
+    std::size_t extent(int d) const {
+        FCPP_CHECK_BOUNDS(0 <= d && d < rank_);
+        return this->get()->dim[d].extent;
+    }
+
+    T* data() const { return static_cast<T*>(this->get()->base_addr); }
+
+private:
+    template<typename, int> friend class chunked_reader;
+
+    CFI_CDESC_T(rank_) desc_;
+    std::size_t first_{0};
+};
+
+/**
+ *  Read an array from a file in chunks along the last dimension (the 
+ *  slowest varying in column-major order), so each chunk is contiguous
+ *  both in the file and in memory
+ *
+ *  A background thread fills a rotating set of page-aligned buffers 
+ *  ahead of the consumer; next() hands out the chunks in order and 
+ *  recycles the previous one.
+ *
+ *    chunked_reader<double,2> r("series.arr", 64);
+ *    while (auto c = r.next()) kernel(*c);
+ */
+template<typename T, int rank_ = 1>
+class chunked_reader {
+public:
+
+    static_assert(rank_ >= 1, "Rank must be positive");
+    static_assert(std::is_trivially_copyable_v<T>,
+        "Elements must be trivially copyable");
+
+    using chunk_type = stream_chunk<T,rank_>;
+    using extents_type = std::array<CFI_index_t,rank_>;
+
+    // File written by save_array, mapped_array::create or chunked_writer
+    chunked_reader(const std::string& path, std::size_t chunk, stream_options opts = {}) {
+        const array_file_header h = Fcpp_impl_::read_array_header<T,rank_>(path);
+        extents_type extents;
+        for (int d = 0; d < rank_; ++d) extents[d] = h.extent[d];
+        this->start(path, extents, chunk, static_cast<off_t>(h.data_offset), opts);
+    }
+
+    // File holding only the elements, starting at byte offset
+    chunked_reader(const std::string& path, const extents_type& extents, 
+                   std::size_t chunk, stream_options opts = {}, std::size_t offset = 0) {
+        this->start(path, extents, chunk, static_cast<off_t>(offset), opts);
+    }
+
+    chunked_reader(const chunked_reader&) = delete;
+    chunked_reader& operator=(const chunked_reader&) = delete;
+
+    ~chunked_reader() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        if (worker_.joinable()) worker_.join();
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+    // Number of chunks
+    std::size_t size() const { return num_chunks_; }
+
+    // The next chunk, or nullptr at the end of the array; the chunk 
+    // returned by the previous call is no longer valid
+    const chunk_type* next() {
+        std::unique_lock lock(mutex_);
+        if (current_ < num_chunks_) {
+            slots_[current_ % slots_.size()].status = state::free;
+            cv_.notify_all();
+        }
+        current_ = next_;
+        if (next_ == num_chunks_) return nullptr;
+
+        slot& s = slots_[next_ % slots_.size()];
+        cv_.wait(lock, [&] { return s.status == state::ready || error_; });
+        if (s.status != state::ready) std::rethrow_exception(error_);
+        ++next_;
+        return &s.chunk;
+    }
+
+private:
+
+    enum class state { free, ready };
+
+    struct slot {
+        aligned_vector<T,4096> buffer;
+        chunk_type chunk;
+        state status = state::free;
+    };
+
+    void start(const std::string& path, const extents_type& extents, 
+               std::size_t chunk, off_t offset, stream_options opts) {
+        FCPP_CHECK(chunk > 0 && opts.buffers > 0);
+
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0) Fcpp_impl_::throw_errno("open " + path);
+
+        extents_ = extents;
+        offset_ = offset;
+        chunk_ = chunk;
+        slab_ = 1;
+        for (int d = 0; d < rank_ - 1; ++d) slab_ *= static_cast<std::size_t>(extents[d]);
+        const std::size_t last = static_cast<std::size_t>(extents[rank_-1]);
+        num_chunks_ = (last + chunk - 1) / chunk;
+        current_ = num_chunks_;
+
+        slots_ = std::vector<slot>(std::min(opts.buffers, std::max<std::size_t>(num_chunks_,1)));
+        for (auto& s : slots_) {
+            s.buffer.resize(std::max<std::size_t>(chunk*slab_,1));
+            if (opts.lock_memory) ::mlock(s.buffer.data(), s.buffer.size()*sizeof(T));
+        }
+
+        ::posix_fadvise(fd_, offset_, 0, POSIX_FADV_SEQUENTIAL);
+        worker_ = std::thread([this] { this->produce(); });
+    }
+
+    void produce() {
+        try {
+            const std::size_t last = static_cast<std::size_t>(extents_[rank_-1]);
+            for (std::size_t k = 0; k < num_chunks_; ++k) {
+                slot& s = slots_[k % slots_.size()];
+                {
+                    std::unique_lock lock(mutex_);
+                    cv_.wait(lock, [&] { return stop_ || s.status == state::free; });
+                    if (stop_) return;
+                }
+
+                const std::size_t first = k*chunk_;
+                const std::size_t count = std::min(chunk_, last - first);
+                Fcpp_impl_::transfer<true>(fd_, reinterpret_cast<char*>(s.buffer.data()), 
+                    count*slab_*sizeof(T), offset_ + static_cast<off_t>(first*slab_*sizeof(T)), 
+                    "read");
+
+                extents_type ext = extents_;
+                ext[rank_-1] = static_cast<CFI_index_t>(count);
+                [[maybe_unused]] int status = CFI_establish(s.chunk.get(), s.buffer.data(), 
+                    CFI_attribute_other, Fcpp_impl_::type<T>(), sizeof(T), rank_, ext.data());
+                FCPP_CHECK(status == CFI_SUCCESS);
+                s.chunk.first_ = first;
+
+                {
+                    std::lock_guard lock(mutex_);
+                    s.status = state::ready;
+                }
+                cv_.notify_all();
+            }
+        } catch (...) {
+            {
+                std::lock_guard lock(mutex_);
+                error_ = std::current_exception();
+            }
+            cv_.notify_all();
+        }
+    }
+
+    int fd_{-1};
+    off_t offset_{0};
+    extents_type extents_{};
+    std::size_t chunk_{0}, slab_{1}, num_chunks_{0};
+    std::size_t next_{0}, current_{0};
+
+    std::vector<slot> slots_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::exception_ptr error_;
+    bool stop_{false};
+    std::thread worker_;
+};
+
+/**
+ *  Write an array to a file (in the format of save_array) as a sequence
+ *  of chunks along the last dimension, in a background thread
+ *
+ *  write() queues the array by reference and returns immediately, unless 
+ *  `depth` writes are already pending; the elements must not change 
+ *  until flush() or close() returns. Runs of contiguous elements are 
+ *  written with pwritev directly from the array, without staging copies; 
+ *  only arrays whose first dimension is strided are packed.
+ */
+template<typename T, int rank_ = 1>
+class chunked_writer {
+public:
+
+    static_assert(rank_ >= 1, "Rank must be positive");
+    static_assert(std::is_trivially_copyable_v<T>,
+        "Elements must be trivially copyable");
+
+    using extents_type = std::array<CFI_index_t,rank_>;
+
+    chunked_writer(const std::string& path, const extents_type& extents, 
+                   std::size_t depth = 2) : extents_(extents), depth_(std::max<std::size_t>(depth,1)) {
+        Fcpp_impl_::write_array_header<T,rank_>(path, extents.data());
+        fd_ = ::open(path.c_str(), O_WRONLY);
+        if (fd_ < 0) Fcpp_impl_::throw_errno("open " + path);
+
+        std::size_t n = 1;
+        for (int d = 0; d < rank_; ++d) n *= static_cast<std::size_t>(extents[d]);
+        if (::ftruncate(fd_, Fcpp_impl_::array_file_data_offset + 
+                static_cast<off_t>(n*sizeof(T))) != 0) {
+            Fcpp_impl_::throw_errno("ftruncate " + path);
+        }
+        worker_ = std::thread([this] { this->consume(); });
+    }
+
+    chunked_writer(const chunked_writer&) = delete;
+    chunked_writer& operator=(const chunked_writer&) = delete;
+
+    ~chunked_writer() {
+        try { this->close(); } catch (...) {} // call close() to see errors
+    }
+
+    // Queue the next chunk (cdesc, cdesc_ptr or cdesc_view), whose 
+    // leading extents must be those of the file
+    template<typename Array>
+    void write(const Array& a) {
+        static_assert(Fcpp_impl_::array_rank<Array>::value == rank_);
+        const CFI_cdesc_t *desc = a.get();
+        FCPP_CHECK(desc->elem_len == sizeof(T));
+        for (int d = 0; d < rank_ - 1; ++d) FCPP_CHECK(desc->dim[d].extent == extents_[d]);
+        FCPP_CHECK(written_ + desc->dim[rank_-1].extent <= extents_[rank_-1]);
+
+        job j;
+        std::memcpy(&j.desc, desc, sizeof(j.desc));
+        j.offset = Fcpp_impl_::array_file_data_offset + 
+            static_cast<off_t>(this->slab()*written_*sizeof(T));
+        written_ += desc->dim[rank_-1].extent;
+
+        std::unique_lock lock(mutex_);
+        cv_.wait(lock, [&] { return queue_.size() < depth_ || error_; });
+        if (error_) std::rethrow_exception(error_);
+        queue_.push_back(j);
+        cv_.notify_all();
+    }
+
+    // Wait for the pending writes
+    void flush() {
+        std::unique_lock lock(mutex_);
+        cv_.wait(lock, [&] { return (queue_.empty() && !busy_) || error_; });
+        if (error_) std::rethrow_exception(error_);
+    }
+
+    // Flush, stop the background thread and close the file
+    void close() {
+        if (fd_ < 0) return;
+        std::exception_ptr err;
+        try { this->flush(); } catch (...) { err = std::current_exception(); }
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        worker_.join();
+        ::close(fd_);
+        fd_ = -1;
+        if (err) std::rethrow_exception(err);
+    }
+
+    // Number of indices written along the last dimension
+    CFI_index_t written() const { return written_; }
+
+private:
+
+    struct job {
+        CFI_CDESC_T(rank_) desc;
+        off_t offset;
+    };
+
+    std::size_t slab() const {
+        std::size_t n = 1;
+        for (int d = 0; d < rank_ - 1; ++d) n *= static_cast<std::size_t>(extents_[d]);
+        return n;
+    }
+
+    void consume() {
+        while (true) {
+            job j;
+            {
+                std::unique_lock lock(mutex_);
+                cv_.wait(lock, [&] { return stop_ || !queue_.empty(); });
+                if (queue_.empty()) return;
+                j = queue_.front();
+                busy_ = true;
+                queue_.pop_front();
+            }
+            try {
+                this->write_job(j);
+            } catch (...) {
+                std::lock_guard lock(mutex_);
+                error_ = std::current_exception();
+                queue_.clear();
+            }
+            {
+                std::lock_guard lock(mutex_);
+                busy_ = false;
+            }
+            cv_.notify_all();
+        }
+    }
+
+    void write_job(const job& j) {
+        const CFI_cdesc_t *desc = (const CFI_cdesc_t *) &j.desc;
+        const auto r = Fcpp_impl_::coalesce<rank_>(desc);
+        if (r.size <= 0) return;
+
+        if (r.sm[0] != static_cast<CFI_index_t>(sizeof(T))) {
+            scratch_.resize(static_cast<std::size_t>(r.size));
+            Fcpp_impl_::copy_runs<true,rank_>(desc, scratch_.data());
+            Fcpp_impl_::transfer<false>(fd_, reinterpret_cast<char*>(scratch_.data()),
+                scratch_.size()*sizeof(T), j.offset, "write");
+            return;
+        }
+
+        // One iovec per contiguous run, submitted in groups of IOV_MAX
+        std::vector<iovec> iov;
+        std::array<CFI_index_t,rank_> idx{};
+        char *base = static_cast<char*>(desc->base_addr);
+        const std::size_t run = static_cast<std::size_t>(r.extent[0])*sizeof(T);
+        off_t offset = j.offset;
+
+        auto submit = [&] {
+            for (const iovec& v : iov) {
+                // pwritev may write partially; fall back per run
+                Fcpp_impl_::transfer<false>(fd_, static_cast<char*>(v.iov_base), 
+                    v.iov_len, offset, "write");
+                offset += static_cast<off_t>(v.iov_len);
+            }
+            iov.clear();
+        };
+        auto submit_vectored = [&] {
+            std::size_t total = 0;
+            for (const iovec& v : iov) total += v.iov_len;
+            const ssize_t k = ::pwritev(fd_, iov.data(), static_cast<int>(iov.size()), offset);
+            if (k == static_cast<ssize_t>(total)) {
+                offset += k;
+                iov.clear();
+            } else {
+                submit();
+            }
+        };
+
+        while (true) {
+            char *p = base;
+            for (int d = 1; d < r.rank; ++d) p += idx[d]*r.sm[d];
+            iov.push_back({p, run});
+            if (iov.size() == IOV_MAX) submit_vectored();
+
+            int d = 1;
+            for (; d < r.rank; ++d) {
+                if (++idx[d] < r.extent[d]) break;
+                idx[d] = 0;
+            }
+            if (d >= r.rank) break;
+        }
+        if (!iov.empty()) submit_vectored();
+    }
+
+    int fd_{-1};
+    extents_type extents_;
+    std::size_t depth_;
+    CFI_index_t written_{0};
+
+    std::vector<T> scratch_;
+    std::deque<job> queue_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::exception_ptr error_;
+    bool busy_{false};
+    bool stop_{false};
+    std::thread worker_;
+};
+
+} // namespace Fcpp
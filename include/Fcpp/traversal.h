@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <numeric>
+#include <span>
+
+#include "../Fcpp.h"
+
+#ifndef FCPP_L1_CACHE_BYTES
+#define FCPP_L1_CACHE_BYTES 32768
+#endif
+
+namespace Fcpp {
+
+/**
+ *  Rank-1 view of elements with a constant (possibly negative)
+ *  stride, used for the rows of a non-contiguous array
+ */
+template<typename T>
+class strided_span {
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using size_type = std::size_t;
+    using iterator = Fcpp_impl_::strided_iterator<T>;
+
+    constexpr strided_span() = default;
+    constexpr strided_span(T* ptr, size_type n, std::ptrdiff_t stride) 
+        : ptr_(ptr), size_(n), stride_(stride) {}
+
+    constexpr T* data() const { return ptr_; }
+    constexpr size_type size() const { return size_; }
+    constexpr bool empty() const { return size_ == 0; }
+    constexpr std::ptrdiff_t stride() const { return stride_; }
+
+    constexpr T& operator[](size_type idx) const { 
+        return ptr_[static_cast<std::ptrdiff_t>(idx)*stride_]; 
+    }
+
+    constexpr iterator begin() const { return iterator(ptr_,stride_); }
+    constexpr iterator end() const { return begin() + static_cast<std::ptrdiff_t>(size_); }
+
+private:
+    T* ptr_{nullptr};
+    size_type size_{0};
+    std::ptrdiff_t stride_{1};
+};
+
+/**
+ *  Tile extents (in elements) of the two dimensions with the smallest
+ *  strides; zero selects a size based on FCPP_L1_CACHE_BYTES
+ */
+struct tile_extents {
+    std::size_t inner = 0;
+    std::size_t outer = 0;
+};
+
+namespace Fcpp_impl_ {
+
+template<typename T>
+constexpr tile_extents default_tile(std::size_t n_inner, std::size_t n_outer) {
+    // Half of the L1 cache is left for the data touched by the callback
+    constexpr std::size_t budget = std::max<std::size_t>(FCPP_L1_CACHE_BYTES / (2*sizeof(T)), 1);
+    tile_extents tile;
+    tile.inner = std::max<std::size_t>(std::min(n_inner, budget), 1);
+    tile.outer = std::max<std::size_t>(std::min(n_outer, budget / tile.inner), 1);
+    return tile;
+}
+
+} // namespace Fcpp_impl_
+
+/**
+ *  Visit a rank-N array (cdesc, cdesc_ptr or cdesc_view) row by row,
+ *  in tiles that fit in the L1 cache.
+ *
+ *  The dimensions are ordered by increasing memory stride, so that rows
+ *  run along the dimension with the smallest stride (the first one for
+ *  column-major arrays). Tiles span the two fastest dimensions; the 
+ *  remaining dimensions are visited in memory order.
+ *
+ *  The callback is invoked as f(row, index), where index holds the 
+ *  zero-based indices of the first element of the row, and row is a
+ *  std::span<T> when the row has unit stride and a strided_span<T> 
+ *  otherwise (so f is typically a generic lambda).
+ */
+template<typename Array, typename F>
+void for_each_row(const Array& a, F&& f, tile_extents tile = {}) {
+
+    using T = typename Array::value_type;
+    constexpr int rank_ = Fcpp_impl_::array_rank<std::remove_cv_t<Array>>::value;
+
+    const CFI_cdesc_t *desc = a.get();
+    T *base = static_cast<T*>(desc->base_addr);
+
+    std::array<std::ptrdiff_t,rank_> index{};
+
+    if constexpr (rank_ == 0) {
+        f(std::span<T>(base,1),index);
+        return;
+    } else {
+
+        std::array<std::ptrdiff_t,rank_> ext, sm;
+        for (int d = 0; d < rank_; ++d) {
+            ext[d] = desc->dim[d].extent;
+            if (ext[d] <= 0) return;
+            FCPP_CHECK(desc->dim[d].sm % static_cast<CFI_index_t>(sizeof(T)) == 0);
+            sm[d] = desc->dim[d].sm / static_cast<CFI_index_t>(sizeof(T));
+        }
+
+        // Order of the dimensions, fastest first
+        std::array<int,rank_> p;
+        std::iota(p.begin(),p.end(),0);
+        std::stable_sort(p.begin(),p.end(),[&](int l, int r) {
+            return std::abs(sm[l]) < std::abs(sm[r]);
+        });
+
+        const int i_ = p[0];
+        const std::size_t ni = ext[i_];
+        const std::size_t nj = rank_ > 1 ? ext[p[1]] : 1;
+
+        const tile_extents def = Fcpp_impl_::default_tile<T>(ni,nj);
+        const std::size_t bi = tile.inner ? tile.inner : def.inner;
+        const std::size_t bj = tile.outer ? tile.outer : def.outer;
+
+        auto visit = [&](T *row, std::size_t n) {
+            if (sm[i_] == 1) {
+                f(std::span<T>(row,n),index);
+            } else {
+                f(strided_span<T>(row,n,sm[i_]),index);
+            }
+        };
+
+        // Odometer over the dimensions p[2], p[3], ...
+        while (true) {
+            std::ptrdiff_t offset = 0;
+            for (int k = 2; k < rank_; ++k) {
+                offset += index[p[k]]*sm[p[k]];
+            }
+
+            for (std::size_t j0 = 0; j0 < nj; j0 += bj) {
+                const std::size_t j1 = std::min(j0 + bj, nj);
+                for (std::size_t i0 = 0; i0 < ni; i0 += bi) {
+                    const std::size_t n = std::min(bi, ni - i0);
+                    for (std::size_t j = j0; j < j1; ++j) {
+                        index[i_] = i0;
+                        std::ptrdiff_t off = offset + static_cast<std::ptrdiff_t>(i0)*sm[i_];
+                        if constexpr (rank_ > 1) {
+                            index[p[1]] = j;
+                            off += static_cast<std::ptrdiff_t>(j)*sm[p[1]];
+                        }
+                        visit(base + off, n);
+                    }
+                }
+            }
+
+            int k = 2;
+            for (; k < rank_; ++k) {
+                if (++index[p[k]] < ext[p[k]]) break;
+                index[p[k]] = 0;
+            }
+            if (k >= rank_) break;
+        }
+    }
+}
+
+} // namespace Fcpp
@@ -0,0 +1,110 @@
+#pragma once
+
+// Dispatch of assumed-rank (dimension(..)) arguments on rank and type
+
+#include <array>
+#include <complex>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+#include "../Fcpp.h"
+
+namespace Fcpp {
+
+template<typename... Ts>
+struct type_list {};
+
+template<int... r>
+struct rank_list {};
+
+// Element types and ranks tried by visit unless others are listed;
+// ranks up to 7, the Fortran 2003 maximum, keep the number of
+// instantiations of the kernel moderate
+using visit_types = type_list<float, double, std::complex<float>, std::complex<double>,
+                              std::int32_t, std::int64_t>;
+using visit_ranks = rank_list<0, 1, 2, 3, 4, 5, 6, 7>;
+
+namespace Fcpp_impl_ {
+
+template<typename T, int rank_, typename F>
+decltype(auto) invoke_with(CFI_cdesc_t *desc, F& f) {
+    switch (desc->attribute) {
+    case CFI_attribute_allocatable:
+        return f(cdesc_ptr<T,rank_,Fcpp::attr::allocatable>(desc));
+    case CFI_attribute_pointer:
+        return f(cdesc_ptr<T,rank_,Fcpp::attr::pointer>(desc));
+    default:
+        return f(cdesc_ptr<T,rank_>(desc));
+    }
+}
+
+template<typename R, typename T, int rank_, typename F>
+R invoke_entry(CFI_cdesc_t *desc, F& f) {
+    return invoke_with<T,rank_>(desc,f);
+}
+
+[[noreturn]] inline void visit_failed(const CFI_cdesc_t *desc, const char *what) {
+    throw std::invalid_argument(std::string("Fcpp::visit: ") + what + " (rank " +
+        std::to_string(desc->rank) + ", type " + std::to_string(desc->type) + ")");
+}
+
+// Kernels for element type T, indexed like the ranks r
+template<typename R, typename F, typename T, int... r>
+constexpr std::array<R (*)(CFI_cdesc_t *, F&),sizeof...(r)> kernel_table(rank_list<r...>) {
+    return {&invoke_entry<R,T,r,F>...};
+}
+
+template<typename F, typename... Ts, int... r>
+decltype(auto) visit(CFI_cdesc_t *desc, F& f, type_list<Ts...>, rank_list<r...>) {
+
+    static_assert(sizeof...(Ts) > 0 && sizeof...(r) > 0, "Nothing to dispatch to");
+    constexpr std::array<int,sizeof...(r)> ranks{r...};
+    using T0 = std::tuple_element_t<0,std::tuple<Ts...>>;
+    using R = decltype(invoke_with<T0,ranks[0]>(desc,f));
+
+    std::size_t k = 0;
+    while (k < ranks.size() && ranks[k] != desc->rank) ++k;
+    if (k == ranks.size()) visit_failed(desc,"rank not dispatched");
+
+    if (desc->rank > 0 && desc->dim[desc->rank-1].extent == -1) {
+        visit_failed(desc,"assumed-size array, see cdesc_view::assumed_size");
+    }
+
+    R (*kernel)(CFI_cdesc_t *, F&) = nullptr;
+    auto pick = [&]<typename T>() {
+        if (!kernel && type_matches<T>(desc)) kernel = kernel_table<R,F,T>(rank_list<r...>{})[k];
+    };
+    (pick.template operator()<Ts>(), ...);
+    if (!kernel) visit_failed(desc,"type not dispatched");
+
+    return kernel(desc,f);
+}
+
+} // namespace Fcpp_impl_
+
+/**
+ *  Call f with the array described by desc as a cdesc_ptr of its actual
+ *  element type and rank, e.g. for an assumed-rank argument
+ *
+ *    type(*), dimension(..), intent(in) :: a
+ *
+ *  f is instantiated for each combination of Types and Ranks (and array
+ *  attribute), and must return the same type for all of them; a generic
+ *  lambda is the usual choice:
+ *
+ *    visit(a, [](auto x) { ... });
+ *    visit<type_list<double>, rank_list<1,2>>(a, kernel);
+ *
+ *  The selection is made once, through a table of function pointers.
+ *  Descriptors of other types or ranks, and assumed-size arrays, raise
+ *  std::invalid_argument.
+ */
+template<typename Types = visit_types, typename Ranks = visit_ranks, typename F>
+decltype(auto) visit(CFI_cdesc_t *desc, F&& f) {
+    return Fcpp_impl_::visit(desc,f,Types{},Ranks{});
+}
+
+} // namespace Fcpp
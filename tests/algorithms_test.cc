@@ -0,0 +1,165 @@
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Fcpp/algorithms.h"
+using namespace Fcpp;
+
+TEST(algorithms, sumContiguous) {
+
+  // Odd length, so that both the vector and the scalar tail are used
+  std::vector<int> a(1001);
+  std::iota(a.begin(),a.end(),1);
+  cdesc<int> fa(a);
+  EXPECT_EQ(sum(fa),1001*1002/2);
+
+  std::vector<double> b(37,0.5);
+  cdesc<double> fb(b);
+  EXPECT_DOUBLE_EQ(sum(fb),18.5);
+}
+
+TEST(algorithms, sumStridedSection) {
+
+  std::vector<int> a(100);
+  std::iota(a.begin(),a.end(),0);
+  cdesc<int> fa(a);
+
+  // a(2::3) and a(100:1:-1)
+  EXPECT_EQ(sum(fa.section(slice{1,100,3})),
+    std::accumulate(fa.section(slice{1,100,3}).begin(),fa.section(slice{1,100,3}).end(),0));
+  EXPECT_EQ(sum(fa.section(slice{99,-1,-1})),99*100/2);
+}
+
+TEST(algorithms, sumRank2) {
+
+  std::vector<double> a(7*5);
+  std::iota(a.begin(),a.end(),0.0);
+  cdesc<double,2> fa(a.data(),7,5);
+
+  // a(2:6,:) has one run per column
+  auto s = fa.section(slice{1,6},full_extent);
+  double expected = 0;
+  for (std::size_t j = 0; j < 5; ++j)
+    for (std::size_t i = 0; i < 5; ++i) expected += s(i,j);
+  EXPECT_DOUBLE_EQ(sum(s),expected);
+
+  // a(:,2:4) is a single run
+  EXPECT_DOUBLE_EQ(sum(fa.section(full_extent,slice{1,4})),
+    std::accumulate(a.begin()+7,a.begin()+28,0.0));
+}
+
+TEST(algorithms, sumEmpty) {
+
+  std::vector<float> a;
+  cdesc<float> fa(a);
+  EXPECT_EQ(sum(fa),0.0f);
+}
+
+TEST(algorithms, dot) {
+
+  std::vector<double> x(50), y(100);
+  std::iota(x.begin(),x.end(),1.0);
+  std::fill(y.begin(),y.end(),2.0);
+  cdesc<double> fx(x), fy(y);
+
+  // Contiguous x, every other element of y
+  auto ys = fy.section(slice{0,100,2});
+  EXPECT_DOUBLE_EQ(dot(fx,ys),2.0*50*51/2);
+  EXPECT_DOUBLE_EQ(dot(fx,fx),50.0*51*101/6);
+}
+
+TEST(algorithms, dotComplexConjugatesFirst) {
+
+  std::vector<std::complex<double>> x{{0,1},{1,1}}, y{{0,1},{2,0}};
+  cdesc<std::complex<double>> fx(x), fy(y);
+
+  // conj(i)*i + conj(1+i)*2 = 1 + 2 - 2i
+  EXPECT_EQ(dot(fx,fy),std::complex<double>(3,-2));
+}
+
+TEST(algorithms, nrm2) {
+
+  std::vector<double> a{3.0, 4.0, 0.0, 12.0};
+  cdesc<double> fa(a);
+  EXPECT_DOUBLE_EQ(nrm2(fa),13.0);
+
+  // Sum of squares overflows without scaling
+  const double big = 1e200;
+  std::vector<double> b{3*big, 4*big};
+  cdesc<double> fb(b);
+  EXPECT_DOUBLE_EQ(nrm2(fb),5*big);
+
+  const double tiny = 1e-200;
+  std::vector<double> c{3*tiny, 4*tiny};
+  cdesc<double> fc(c);
+  EXPECT_DOUBLE_EQ(nrm2(fc),5*tiny);
+
+  std::vector<double> z(9,0.0);
+  cdesc<double> fz(z);
+  EXPECT_EQ(nrm2(fz),0.0);
+}
+
+TEST(algorithms, axpyStrided) {
+
+  std::vector<double> x(40), y(20,1.0);
+  std::iota(x.begin(),x.end(),0.0);
+  cdesc<double> fx(x), fy(y);
+
+  // y = 2*x(1::2) + y
+  axpy(2.0,fx.section(slice{0,40,2}),fy);
+  for (std::size_t i = 0; i < 20; ++i) EXPECT_EQ(y[i],2.0*(2*i) + 1.0);
+}
+
+TEST(algorithms, scaleSection) {
+
+  std::vector<int> a(4*3,1);
+  cdesc<int,2> fa(a.data(),4,3);
+
+  // a(2,:) = 5*a(2,:)
+  scale(5,fa.section(slice{1,2},full_extent));
+  for (std::size_t j = 0; j < 3; ++j)
+    for (std::size_t i = 0; i < 4; ++i) EXPECT_EQ(fa(i,j),i == 1 ? 5 : 1);
+}
+
+TEST(algorithms, fmaInPlace) {
+
+  std::vector<float> x(33), y(33,2.0f), z(33,1.0f);
+  std::iota(x.begin(),x.end(),0.0f);
+  cdesc<float> fx(x), fy(y), fz(z);
+
+  // z = x*y + z
+  Fcpp::fma(fx,fy,fz,fz);
+  for (std::size_t i = 0; i < 33; ++i) EXPECT_EQ(z[i],2.0f*i + 1.0f);
+}
+
+TEST(algorithms, minmax) {
+
+  std::vector<double> a(101);
+  for (std::size_t i = 0; i < a.size(); ++i) a[i] = std::sin(0.1*i);
+  cdesc<double> fa(a);
+
+  const auto [lo,hi] = minmax(fa);
+  const auto [elo,ehi] = std::minmax_element(a.begin(),a.end());
+  EXPECT_EQ(lo,*elo);
+  EXPECT_EQ(hi,*ehi);
+  EXPECT_EQ(argmin(fa),static_cast<std::size_t>(elo - a.begin()));
+  EXPECT_EQ(argmax(fa),static_cast<std::size_t>(ehi - a.begin()));
+}
+
+TEST(algorithms, argminStridedRank2) {
+
+  std::vector<int> a(6*5,10);
+  cdesc<int,2> fa(a.data(),6,5);
+  fa(4,3) = -1;
+  fa(4,1) = 42;
+
+  // a(1::2,:): element (4,3) is at position 2 + 3*3
+  auto s = fa.section(slice{0,6,2},full_extent);
+  EXPECT_EQ(argmin(s),11u);
+  EXPECT_EQ(argmax(s),5u);
+  EXPECT_EQ(minmax(s),std::make_pair(-1,42));
+}
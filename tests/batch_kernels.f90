@@ -0,0 +1,22 @@
+! double batch_sum_one(CFI_cdesc_t *a);
+real(c_double) function batch_sum_one(a) bind(c)
+use, intrinsic :: iso_c_binding, only: c_double
+implicit none
+real(c_double), intent(in) :: a(:)
+batch_sum_one = sum(a)
+end function
+
+! void batch_sums(CFI_cdesc_t *addrs, CFI_cdesc_t *exts, CFI_cdesc_t *sums);
+subroutine batch_sums(addrs,exts,sums) bind(c)
+use, intrinsic :: iso_c_binding, only: c_ptr, c_ptrdiff_t, c_double, c_f_pointer
+implicit none
+type(c_ptr), intent(in) :: addrs(:)
+integer(c_ptrdiff_t), intent(in) :: exts(:,:)
+real(c_double), intent(out) :: sums(:)
+real(c_double), pointer :: a(:)
+integer :: i
+do i = 1, size(addrs)
+  call c_f_pointer(addrs(i), a, [exts(1,i)])
+  sums(i) = sum(a)
+end do
+end subroutine
@@ -0,0 +1,100 @@
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Fcpp/batch.h"
+using namespace Fcpp;
+
+extern "C" {
+  double batch_sum_one(CFI_cdesc_t *a);
+  void batch_sums(CFI_cdesc_t *addrs, CFI_cdesc_t *exts, CFI_cdesc_t *sums);
+}
+
+static std::vector<std::vector<double>> make_cells(int n) {
+  std::vector<std::vector<double>> cells(n);
+  for (int i = 0; i < n; ++i) {
+    cells[i].resize(i % 5);
+    std::iota(cells[i].begin(),cells[i].end(),1.0);
+  }
+  return cells;
+}
+
+TEST(cdesc_batch_class, fromContainers) {
+
+  auto cells = make_cells(100);
+  cdesc_batch<double> batch(cells);
+
+  ASSERT_EQ(batch.size(),cells.size());
+  for (std::size_t i = 0; i < cells.size(); ++i) {
+    CFI_cdesc_t *d = batch[i];
+    EXPECT_EQ(d->rank,1);
+    EXPECT_EQ(d->type,CFI_type_double);
+    EXPECT_EQ(d->dim[0].extent,cells[i].size());
+    if (!cells[i].empty()) {
+      EXPECT_EQ(d->base_addr,cells[i].data());
+    }
+    EXPECT_EQ(batch.data()[i],d);
+  }
+}
+
+TEST(cdesc_batch_class, callFortranPerArray) {
+
+  auto cells = make_cells(50);
+  cdesc_batch<double> batch(cells);
+
+  for (std::size_t i = 0; i < batch.size(); ++i) {
+    EXPECT_EQ(batch_sum_one(batch[i]), 
+      std::accumulate(cells[i].begin(),cells[i].end(),0.0));
+  }
+}
+
+TEST(cdesc_batch_class, fortranSideLoop) {
+
+  auto cells = make_cells(37);
+  cdesc_batch<double> batch(cells);
+
+  std::vector<double> sums(cells.size());
+  batch_sums(batch.addresses(),batch.extents(),cdesc(sums));
+
+  for (std::size_t i = 0; i < cells.size(); ++i) {
+    EXPECT_EQ(sums[i],std::accumulate(cells[i].begin(),cells[i].end(),0.0));
+  }
+}
+
+TEST(cdesc_batch_class, pushBackRank2) {
+
+  std::vector<int> a(12), b(6);
+  cdesc_batch<int,2> batch;
+  batch.push_back(a.data(),3,4);
+  batch.push_back(b.data(),2,3);
+
+  auto ext = batch.extents();
+  EXPECT_EQ(ext(0,0),3);
+  EXPECT_EQ(ext(1,0),4);
+  EXPECT_EQ(ext(0,1),2);
+  EXPECT_EQ(ext(1,1),3);
+
+  EXPECT_EQ(batch[1]->dim[1].sm,2*sizeof(int));
+  EXPECT_EQ(CFI_is_contiguous(batch[0]),1);
+
+  auto descs = batch.descriptors();
+  EXPECT_EQ(descs.get()->type,CFI_type_cptr);
+  EXPECT_EQ(descs[1],batch[1]);
+}
+
+TEST(cdesc_batch_class, assignReusesStorage) {
+
+  auto cells = make_cells(20);
+  cdesc_batch<double> batch(cells);
+  const CFI_cdesc_t *first = batch[0];
+
+  cells.resize(10);
+  batch.assign(cells);
+  EXPECT_EQ(batch.size(),10);
+  EXPECT_EQ(batch[0],first);
+
+  cdesc_batch<double> moved(std::move(batch));
+  EXPECT_EQ(moved[0],first);
+  EXPECT_EQ(moved.data()[9]->dim[0].extent,cells[9].size());
+}
@@ -0,0 +1,20 @@
+! void alloc_iota(CFI_cdesc_t *a, int n);
+subroutine alloc_iota(a,n) bind(c)
+use, intrinsic :: iso_c_binding, only: c_int
+implicit none
+integer(c_int), allocatable, intent(inout) :: a(:)
+integer(c_int), value :: n
+integer :: i
+if (allocated(a)) deallocate(a)
+allocate(a(n))
+a = [(i, i = 1, n)]
+end subroutine
+
+! int sum_alloc(CFI_cdesc_t *a);
+integer(c_int) function sum_alloc(a) bind(c)
+use, intrinsic :: iso_c_binding, only: c_int
+implicit none
+integer(c_int), allocatable, intent(in) :: a(:,:)
+sum_alloc = -1
+if (allocated(a)) sum_alloc = sum(a)
+end function
@@ -1,6 +1,7 @@
 
 #include <algorithm>
 #include <numeric>
+#include <valarray>
 
 #include <gtest/gtest.h>
 
@@ -191,6 +192,34 @@ TEST(cdesc_class, implicitCastCdesc) {
 
 }
 
+TEST(cdesc_class, constElements) {
+
+  const std::vector<int> b(10,2);
+  const cdesc<const int> fb(b);
+  static_assert(std::is_same_v<decltype(fb[0]),const int&>);
+  EXPECT_EQ(fb.get()->base_addr,b.data());
+
+  // Passed to an intent(in) argument
+  EXPECT_TRUE( alltwo(fb) > 0 );
+
+  // Read-only descriptors and views of a mutable array
+  std::vector<int> a(6);
+  std::iota(a.begin(),a.end(),0);
+  cdesc<int> fa(a);
+  cdesc<const int> ca(fa);
+  EXPECT_EQ(ca[5],5);
+
+  cdesc_view<const int,1> va = fa.section(slice{1,6,2});
+  EXPECT_EQ(va[2],5);
+
+  const CFI_cdesc_t *in = fa.get();
+  cdesc_ptr<const int,1> pa(in);
+  cdesc_ptr<const int,1> pb(cdesc_ptr<int,1>(fa.get()));
+  static_assert(std::is_same_v<decltype(*pa.begin()),const int&>);
+  EXPECT_EQ(std::accumulate(pa.begin(),pa.end(),0),15);
+  EXPECT_EQ(pb[3],3);
+}
+
 #if __cpp_lib_span
 TEST(cdesc_class, implicitCastSpan) {
 
@@ -209,4 +238,605 @@ TEST(cdesc_class, implicitCastSpan) {
   EXPECT_EQ(b.data(),sb.data());
   
 }
-#endif
\ No newline at end of file
+#endif
+
+// Establish a rank-1 section of the form a(lower:upper:step)
+// (zero-based bounds) in the descriptor sec.
+static void make_section(CFI_cdesc_t *sec, CFI_cdesc_t *a, 
+    CFI_index_t lower, CFI_index_t upper, CFI_index_t step) {
+  
+  CFI_index_t ext[1] = {a->dim[0].extent};
+  int status = CFI_establish(sec, a->base_addr, 
+      CFI_attribute_other, a->type, a->elem_len, 1, ext);
+  ASSERT_EQ(status, CFI_SUCCESS);
+
+  CFI_index_t lb[1] = {lower}, ub[1] = {upper}, st[1] = {step};
+  status = CFI_section(sec, a, lb, ub, st);
+  ASSERT_EQ(status, CFI_SUCCESS);
+}
+
+static_assert(std::random_access_iterator<cdesc_ptr<int,1>::iterator>);
+static_assert(std::random_access_iterator<cdesc_ptr<int,1>::const_iterator>);
+static_assert(std::sortable<cdesc_ptr<int,1>::iterator>);
+
+TEST(cdesc_ptr_class, stridedIteratorArithmetic) {
+
+  std::vector<int> a = {0,1,2,3,4,5,6,7,8,9};
+  cdesc fa(a);
+
+  CFI_CDESC_T(1) sec;
+  make_section((CFI_cdesc_t *) &sec, fa, 1, 9, 2); // a(2::2)
+  cdesc_ptr<int,1> s((CFI_cdesc_t *) &sec);
+
+  EXPECT_EQ(s.extent(0),5);
+  EXPECT_EQ(s.end() - s.begin(),5);
+  EXPECT_EQ(std::distance(s.cbegin(),s.cend()),5);
+
+  auto it = s.begin();
+  EXPECT_EQ(it[3],7);
+  it += 2;
+  EXPECT_EQ(*it,5);
+  EXPECT_EQ(*(it - 1),3);
+  EXPECT_EQ(*(1 + it),7);
+  EXPECT_TRUE(s.begin() < it);
+  EXPECT_TRUE(it <= s.end());
+  EXPECT_TRUE(s.cbegin() == s.begin());
+
+  std::vector<int> b(s.begin(),s.end());
+  EXPECT_EQ(b,(std::vector<int>{1,3,5,7,9}));
+}
+
+TEST(cdesc_ptr_class, stridedSortAndSearch) {
+
+  std::vector<int> a = {9,0,7,0,5,0,3,0,1,0};
+  cdesc fa(a);
+
+  CFI_CDESC_T(1) sec;
+  make_section((CFI_cdesc_t *) &sec, fa, 0, 9, 2); // a(1::2)
+  cdesc_ptr<int,1> s((CFI_cdesc_t *) &sec);
+
+  std::sort(s.begin(),s.end());
+  EXPECT_EQ(a,(std::vector<int>{1,0,3,0,5,0,7,0,9,0}));
+
+  auto it = std::lower_bound(s.cbegin(),s.cend(),6);
+  EXPECT_EQ(*it,7);
+  EXPECT_EQ(it - s.cbegin(),3);
+
+  std::nth_element(s.begin(),s.begin() + 2,s.end(),std::greater<>{});
+  EXPECT_EQ(s[2],5);
+}
+
+TEST(cdesc_ptr_class, reversedSection) {
+
+  std::vector<int> a = {0,1,2,3,4};
+  cdesc fa(a);
+
+  CFI_CDESC_T(1) sec;
+  make_section((CFI_cdesc_t *) &sec, fa, 4, 0, -1); // a(5:1:-1)
+  cdesc_ptr<int,1> s((CFI_cdesc_t *) &sec);
+
+  std::vector<int> b(s.begin(),s.end());
+  EXPECT_EQ(b,(std::vector<int>{4,3,2,1,0}));
+  EXPECT_TRUE(s.begin() < s.end());
+  EXPECT_EQ(s[1],3);
+}
+
+TEST(cdesc_ptr_class, emptyArrayIterators) {
+
+  std::vector<double> a;
+  cdesc fa(a);
+  EXPECT_NE(fa.get()->base_addr,nullptr);
+  EXPECT_EQ(fa.size(),0);
+
+  cdesc_ptr<double,1> p(fa.get());
+  EXPECT_EQ(p.end() - p.begin(),0);
+  EXPECT_EQ(std::lower_bound(p.begin(),p.end(),1.0),p.end());
+  EXPECT_TRUE(std::vector<double>(p.begin(),p.end()).empty());
+  EXPECT_EQ(std::distance(fa.begin(),fa.end()),0);
+
+  // A section with no elements
+  std::vector<double> b(4);
+  cdesc fb(b);
+  auto s = fb.section(slice{1,1});
+  cdesc_ptr<double,1> q(s.get());
+  EXPECT_EQ(q.end() - q.begin(),0);
+  EXPECT_TRUE(std::vector<double>(q.begin(),q.end()).empty());
+}
+
+static_assert(std::is_same_v<cdesc_ptr<int,1,attr::other,layout::contiguous>::iterator,int*>);
+
+TEST(cdesc_ptr_class, contiguousLayout) {
+
+  std::vector<int> a(6);
+  cdesc fa(a);
+
+  cdesc_ptr<int,1,attr::other,layout::contiguous> s(fa.get());
+
+  EXPECT_TRUE(s.is_contiguous());
+  EXPECT_EQ(s.data(),a.data());
+  EXPECT_EQ(s.begin(),a.data());
+  EXPECT_EQ(s.end(),a.data() + a.size());
+
+  std::iota(s.begin(),s.end(),1);
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(s[i],i+1);
+  }
+
+#if __cpp_lib_span
+  std::span<int> sp = s;
+  EXPECT_EQ(sp.data(),a.data());
+  EXPECT_EQ(sp.size(),a.size());
+#endif
+}
+
+#if __cpp_lib_span
+TEST(cdesc_ptr_class, flattenContiguous) {
+
+  std::vector<double> a(12);
+  cdesc<double,2> fa(a.data(),3,4);
+
+  cdesc_ptr<double,2,attr::other,layout::contiguous> s(fa.get());
+  std::span<double> flat = s.flatten();
+
+  EXPECT_EQ(flat.data(),a.data());
+  EXPECT_EQ(flat.size(),12);
+}
+#endif
+
+TEST(cdesc_class, subscript2D) {
+
+  // Column-major 3 x 4 matrix with a(i,j) = 10*i + j
+  std::vector<int> a(12);
+  for (int j = 0; j < 4; ++j) {
+    for (int i = 0; i < 3; ++i) {
+      a[i + 3*j] = 10*i + j;
+    }
+  }
+  cdesc<int,2> fa(a.data(),3,4);
+
+  EXPECT_EQ(fa(0,0),0);
+  EXPECT_EQ(fa(2,0),20);
+  EXPECT_EQ(fa(1,3),13);
+
+  fa(2,3) = -1;
+  EXPECT_EQ(a[11],-1);
+
+  const auto& ca = fa;
+  EXPECT_EQ(ca(0,2),2);
+}
+
+TEST(cdesc_ptr_class, subscript2DSection) {
+
+  // Column-major 4 x 3 matrix with a(i,j) = 10*i + j
+  std::vector<int> a(12);
+  for (int j = 0; j < 3; ++j) {
+    for (int i = 0; i < 4; ++i) {
+      a[i + 4*j] = 10*i + j;
+    }
+  }
+  cdesc<int,2> fa(a.data(),4,3);
+
+  // Section a(2::2,:) using zero-based bounds
+  CFI_CDESC_T(2) sec;
+  CFI_index_t ext[2] = {4,3};
+  ASSERT_EQ(CFI_establish((CFI_cdesc_t *) &sec, a.data(), CFI_attribute_other,
+      CFI_type_int, sizeof(int), 2, ext), CFI_SUCCESS);
+  CFI_index_t lb[2] = {1,0}, ub[2] = {3,2}, st[2] = {2,1};
+  ASSERT_EQ(CFI_section((CFI_cdesc_t *) &sec, fa, lb, ub, st), CFI_SUCCESS);
+
+  cdesc_ptr<int,2> s((CFI_cdesc_t *) &sec);
+  EXPECT_EQ(s.extent(0),2);
+  EXPECT_EQ(s.extent(1),3);
+
+  for (int j = 0; j < 3; ++j) {
+    for (int i = 0; i < 2; ++i) {
+      EXPECT_EQ(s(i,j),10*(2*i+1) + j);
+    }
+  }
+
+  s(1,2) = 0;
+  EXPECT_EQ(a[3 + 4*2],0);
+}
+
+TEST(cdesc_class, fromValarray) {
+
+  std::valarray<double> a(1.0,7);
+  cdesc<double> fa(a);
+  EXPECT_EQ(fa.extent(0),7);
+  EXPECT_EQ(fa.get()->base_addr,&a[0]);
+  fa[6] = 3.0;
+  EXPECT_EQ(a[6],3.0);
+}
+
+// Minimal column-major matrix with padded columns, as Eigen::Map<..., OuterStride<>>
+struct padded_matrix {
+  double *ptr;
+  long m, n, ld;
+  double *data() { return ptr; }
+  long rows() const { return m; }
+  long cols() const { return n; }
+  long innerStride() const { return 1; }
+  long outerStride() const { return ld; }
+};
+
+TEST(cdesc_class, fromMatrixLike) {
+
+  std::vector<double> a(5*4);
+  std::iota(a.begin(),a.end(),0.0);
+  padded_matrix m{a.data(),3,4,5};
+
+  cdesc<double,2> fa(m);
+  EXPECT_EQ(fa.extent(0),3);
+  EXPECT_EQ(fa.extent(1),4);
+  EXPECT_FALSE(fa.is_contiguous());
+  EXPECT_EQ(fa(2,3),17.0);
+
+  // A single column as a rank-1 array
+  padded_matrix col{a.data() + 5,5,1,5};
+  cdesc<double> fc(col);
+  EXPECT_EQ(fc.extent(0),5);
+  EXPECT_EQ(fc[4],9.0);
+}
+
+// Minimal strided view, as Kokkos::View<int**,Kokkos::LayoutStride>
+struct strided_view {
+  static constexpr int rank = 2;
+  int *ptr;
+  std::size_t n[2], s[2];
+  int *data() const { return ptr; }
+  std::size_t extent(int d) const { return n[d]; }
+  std::size_t stride(int d) const { return s[d]; }
+};
+
+TEST(cdesc_class, fromStridedViewLike) {
+
+  std::vector<int> a(6*4);
+  std::iota(a.begin(),a.end(),0);
+  strided_view v{a.data(),{6,2},{1,12}};
+
+  cdesc<int,2> fa(v);
+  EXPECT_EQ(fa.extent(1),2);
+  EXPECT_EQ(fa.get()->dim[1].sm,12*sizeof(int));
+  EXPECT_EQ(fa(5,1),17);
+}
+
+#if FCPP_HAS_MDSPAN
+TEST(cdesc_class, fromMdspanLayoutLeft) {
+
+  std::vector<double> a(12);
+  std::iota(a.begin(),a.end(),0.0);
+  std::mdspan<double,std::dextents<int,2>> m(a.data(),std::dextents<int,2>(3,4));
+
+  cdesc<double,2> fa(m);
+  EXPECT_EQ(fa.extent(0),3);
+  EXPECT_EQ(fa.extent(1),4);
+  EXPECT_EQ(fa.get()->base_addr,a.data());
+  EXPECT_TRUE(fa.is_contiguous());
+  EXPECT_EQ(fa(2,3),(m[2,3]));
+
+  std::mdspan<double,std::dextents<CFI_index_t,2>,std::layout_left> v = fa;
+  EXPECT_EQ(v.data_handle(),a.data());
+  EXPECT_EQ((v[1,2]),fa(1,2));
+}
+
+TEST(cdesc_class, fromMdspanPaddedLayoutStride) {
+
+  // 3 x 4 matrix with leading dimension padded to 5
+  std::vector<int> a(20);
+  std::iota(a.begin(),a.end(),0);
+  using ext_t = std::dextents<CFI_index_t,2>;
+  std::layout_stride::mapping<ext_t> map(ext_t(3,4),std::array<CFI_index_t,2>{1,5});
+  std::mdspan<int,ext_t,std::layout_stride> m(a.data(),map);
+
+  cdesc<int,2> fa(m);
+  EXPECT_FALSE(fa.is_contiguous());
+  EXPECT_EQ(fa.get()->dim[1].sm,5*sizeof(int));
+  EXPECT_EQ(fa(2,3),17);
+
+  auto v = fa.to_mdspan();
+  EXPECT_EQ(v.stride(1),5);
+  EXPECT_EQ((v[2,3]),17);
+}
+
+TEST(cdesc_class, toMdspanConst) {
+
+  std::vector<int> a(12);
+  std::iota(a.begin(),a.end(),0);
+  const cdesc<int,2> fa(a.data(),3,4);
+
+  auto v = fa.to_mdspan();
+  EXPECT_EQ(v.data_handle(),a.data());
+  EXPECT_EQ((v[2,3]),11);
+
+  std::mdspan<int,std::dextents<CFI_index_t,2>,std::layout_left> w = fa;
+  EXPECT_EQ((w[1,2]),7);
+}
+
+TEST(cdesc_ptr_class, toMdspanReversed) {
+
+  std::vector<int> a = {0,1,2,3,4};
+  cdesc fa(a);
+
+  CFI_CDESC_T(1) sec;
+  make_section((CFI_cdesc_t *) &sec, fa, 4, 0, -1); // a(5:1:-1)
+  cdesc_ptr<int,1> s((CFI_cdesc_t *) &sec);
+
+  auto m = s.to_mdspan();
+  EXPECT_EQ(m.mapping().stride(0),-1);
+  EXPECT_EQ(m.mapping().offset(),4);
+  EXPECT_EQ(m.data_handle(),a.data());
+  EXPECT_TRUE(m.mapping().is_exhaustive());
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(m[i],4-i);
+  }
+
+  // Round-trip back into a descriptor
+  cdesc<int,1> r(std::mdspan<int,std::dextents<CFI_index_t,1>,layout_fortran_strided>(
+      a.data(),layout_fortran_strided::mapping<std::dextents<CFI_index_t,1>>(
+          std::dextents<CFI_index_t,1>(5))));
+  EXPECT_EQ(r.get()->base_addr,a.data());
+  EXPECT_TRUE(r.is_contiguous());
+}
+#endif
+
+// Allocates a(n) on the Fortran side and fills it with 1, 2, ..., n
+extern "C" void alloc_iota(CFI_cdesc_t *a, int n);
+// Returns the sum of a rank-2 allocatable array, or -1 if unallocated
+extern "C" int sum_alloc(CFI_cdesc_t *a);
+
+static_assert(!std::is_copy_constructible_v<cdesc<int,1,attr::allocatable>>);
+static_assert(std::is_nothrow_move_constructible_v<cdesc<int,1,attr::allocatable>>);
+
+TEST(cdesc_class, allocatableFromFortran) {
+
+  cdesc<int,1,attr::allocatable> a;
+  EXPECT_FALSE(a.is_allocated());
+
+  alloc_iota(a,4);
+  ASSERT_TRUE(a.is_allocated());
+  EXPECT_EQ(a.extent(0),4);
+  EXPECT_EQ(a(3),4);
+
+  // Reallocation on the Fortran side
+  alloc_iota(a,6);
+  EXPECT_EQ(a.extent(0),6);
+  EXPECT_EQ(std::accumulate(a.begin(),a.end(),0),21);
+
+  // Move transfers the allocation
+  cdesc<int,1,attr::allocatable> b(std::move(a));
+  EXPECT_FALSE(a.is_allocated());
+  EXPECT_TRUE(b.is_allocated());
+  EXPECT_EQ(b[5],6);
+}
+
+TEST(cdesc_class, allocatableResize) {
+
+  cdesc<int,2,attr::allocatable> a;
+  EXPECT_EQ(sum_alloc(a),-1);
+
+  a.allocate(2,3);
+  EXPECT_EQ(a.extent(0),2);
+  EXPECT_EQ(a.extent(1),3);
+  EXPECT_EQ(a.get()->dim[0].lower_bound,1);
+  for (int j = 0; j < 3; ++j) {
+    for (int i = 0; i < 2; ++i) {
+      a(i,j) = 1;
+    }
+  }
+  EXPECT_EQ(sum_alloc(a),6);
+
+  void *p = a.get()->base_addr;
+  a.resize(2,3);
+  EXPECT_EQ(a.get()->base_addr,p);
+
+  a.resize(4,4);
+  EXPECT_EQ(a.extent(0),4);
+  a(3,3) = 7;
+  EXPECT_EQ(a.data()[15],7);
+
+  a.deallocate();
+  EXPECT_FALSE(a.is_allocated());
+}
+
+TEST(cdesc_ptr_class, allocateAndMove) {
+
+  cdesc<double,1,attr::allocatable> fa, fb;
+
+  cdesc_ptr<double,1,attr::allocatable> a(fa.get()), b(fb.get());
+  EXPECT_FALSE(a.is_allocated());
+
+  a.allocate(3);
+  std::fill(a.begin(),a.end(),1.5);
+  EXPECT_EQ(fa(2),1.5);
+
+  a.move_alloc(b);
+  EXPECT_FALSE(a.is_allocated());
+  ASSERT_TRUE(b.is_allocated());
+  EXPECT_EQ(b.extent(0),3);
+  EXPECT_EQ(b[1],1.5);
+}
+
+TEST(cdesc_view_class, section1D) {
+
+  std::vector<int> a = {0,1,2,3,4,5,6,7,8,9};
+  cdesc fa(a);
+
+  // a(2::2) in Fortran
+  auto s = fa.section(slice{1,10,2});
+  static_assert(std::is_same_v<decltype(s),cdesc_view<int,1>>);
+  EXPECT_EQ(s.extent(0),5);
+  EXPECT_FALSE(s.is_contiguous());
+  EXPECT_EQ(s.get()->dim[0].sm,2*sizeof(int));
+
+  std::vector<int> b(s.begin(),s.end());
+  EXPECT_EQ(b,(std::vector<int>{1,3,5,7,9}));
+
+  // The view can be passed to Fortran directly
+  std::fill(s.begin(),s.end(),2);
+  EXPECT_TRUE(alltwo(s) > 0);
+  EXPECT_FALSE(alltwo(fa) > 0);
+
+  // Reversed section of the section
+  auto r = s.section(slice{4,-1,-1});
+  EXPECT_EQ(r.extent(0),5);
+  r[0] = 42;
+  EXPECT_EQ(a[9],42);
+
+  // Empty section
+  auto e = fa.section(slice{3,3});
+  EXPECT_EQ(e.extent(0),0);
+}
+
+TEST(cdesc_view_class, section2D) {
+
+  // Column-major 4 x 3 matrix with a(i,j) = 10*i + j
+  std::vector<int> a(12);
+  for (int j = 0; j < 3; ++j) {
+    for (int i = 0; i < 4; ++i) {
+      a[i + 4*j] = 10*i + j;
+    }
+  }
+  cdesc<int,2> fa(a.data(),4,3);
+
+  // a(2::2,:) in Fortran
+  auto s = fa.section(slice{1,4,2},full_extent);
+  EXPECT_EQ(s.rank(),2);
+  EXPECT_EQ(s.extent(0),2);
+  EXPECT_EQ(s.extent(1),3);
+  EXPECT_EQ(s(1,2),32);
+
+  // Column a(:,3) and row a(2,:) are rank-reducing
+  auto col = fa.section(full_extent,2);
+  static_assert(std::is_same_v<decltype(col),cdesc_view<int,1>>);
+  EXPECT_TRUE(col.is_contiguous());
+  EXPECT_EQ(col[3],32);
+
+  cdesc_ptr<int,2> p(fa.get());
+  auto row = p.section(1,full_extent);
+  EXPECT_EQ(row.extent(0),3);
+  EXPECT_EQ(row.get()->dim[0].sm,4*sizeof(int));
+  EXPECT_EQ(std::accumulate(row.begin(),row.end(),0),30+3);
+}
+
+TEST(cdesc_view_class, selectPart) {
+
+  struct particle { double x, y, z; };
+  static_assert(sizeof(particle) == 3*sizeof(double));
+
+  std::vector<particle> ps(4);
+  for (int i = 0; i < 4; ++i) {
+    ps[i] = {1.0*i, 10.0*i, 100.0*i};
+  }
+  cdesc<particle> fp(ps.data(),4);
+
+  auto y = fp.part(&particle::y);
+  EXPECT_EQ(y.extent(0),4);
+  EXPECT_EQ(y.elem_len(),sizeof(double));
+  EXPECT_EQ(y.get()->dim[0].sm,sizeof(particle));
+  EXPECT_EQ(y[3],30.0);
+
+  y[2] = -1.0;
+  EXPECT_EQ(ps[2].y,-1.0);
+}
+
+TEST(cdesc_class, rebindAndReshape) {
+
+  std::vector<int> a(6,1), b(12,2);
+  cdesc fa(a);
+
+  fa.rebind(b.data());
+  EXPECT_EQ(fa.get()->base_addr,b.data());
+  EXPECT_EQ(fa.extent(0),6);
+  EXPECT_TRUE(alltwo(fa) > 0);
+
+  fa.reshape(12);
+  EXPECT_EQ(fa.extent(0),12);
+  EXPECT_EQ(std::accumulate(fa.begin(),fa.end(),0),24);
+
+  // The result is identical to establishing a new descriptor
+  cdesc<int,2> f2(a.data(),2,3);
+  f2.rebind(b.data(),4,3);
+  cdesc<int,2> ref(b.data(),4,3);
+  for (int d = 0; d < 2; ++d) {
+    EXPECT_EQ(f2.get()->dim[d].lower_bound,ref.get()->dim[d].lower_bound);
+    EXPECT_EQ(f2.get()->dim[d].extent,ref.get()->dim[d].extent);
+    EXPECT_EQ(f2.get()->dim[d].sm,ref.get()->dim[d].sm);
+  }
+  f2(3,2) = 5;
+  EXPECT_EQ(b[11],5);
+}
+
+// Type mapping
+
+static_assert(Fcpp_impl_::type<std::int32_t>() == CFI_type_int32_t);
+static_assert(Fcpp_impl_::type<std::int64_t>() == CFI_type_int64_t);
+static_assert(Fcpp_impl_::type<std::int_fast16_t>() == CFI_type_int_fast16_t);
+static_assert(Fcpp_impl_::type<std::int_least64_t>() == CFI_type_int_least64_t);
+static_assert(Fcpp_impl_::type<std::intptr_t>() == CFI_type_intptr_t);
+static_assert(Fcpp_impl_::type<std::ptrdiff_t>() == CFI_type_ptrdiff_t);
+static_assert(Fcpp_impl_::type<short>() == CFI_type_short);
+static_assert(Fcpp_impl_::type<unsigned>() == CFI_type_int);
+static_assert(Fcpp_impl_::type<std::size_t>() == CFI_type_size_t);
+static_assert(Fcpp_impl_::type<bool>() == Fcpp_impl_::bool_type);
+static_assert(Fcpp_impl_::type<const double>() == CFI_type_double);
+static_assert(Fcpp_impl_::type<long double>() == CFI_type_long_double);
+static_assert(Fcpp_impl_::type<std::complex<long double>>() == CFI_type_long_double_Complex);
+static_assert(Fcpp_impl_::type<int*>() == CFI_type_cptr);
+static_assert(Fcpp_impl_::type<void(*)(int)>() == CFI_type_cfunptr);
+
+struct particle_t { double x, y, z; std::int32_t id; };
+FCPP_INTEROPERABLE_STRUCT(particle_t, 32, 8);
+
+struct opaque_t { double x; };
+
+static_assert(Fcpp_impl_::type<particle_t>() == CFI_type_struct);
+static_assert(Fcpp_impl_::type<opaque_t>() == CFI_type_other);
+
+extern "C" {
+  double sum_x(CFI_cdesc_t *p);
+  int count_true(CFI_cdesc_t *b);
+  std::int64_t sum_int64(CFI_cdesc_t *a);
+}
+
+TEST(cdesc_types, interoperableStruct) {
+
+  std::vector<particle_t> ps(3);
+  for (int i = 0; i < 3; ++i) ps[i] = {1.0 + i, 0.0, 0.0, i};
+
+  cdesc<particle_t> fp(ps.data(),3);
+  EXPECT_EQ(fp.get()->type,CFI_type_struct);
+  EXPECT_EQ(sum_x(fp),9.0);
+
+  cdesc_ptr<particle_t,1> p(fp.get());
+  EXPECT_EQ(p(2).id,2);
+}
+
+TEST(cdesc_types, logicalAndInt64) {
+
+  bool b[5] = {true, false, true, true, false};
+  EXPECT_EQ(count_true(cdesc(b)),3);
+
+  std::vector<std::int64_t> a{1, 1ll << 40, 3};
+  EXPECT_EQ(sum_int64(cdesc<std::int64_t>(a)),(1ll << 40) + 4);
+}
+
+TEST(cdesc_types, typeMatches) {
+
+  int a[4];
+  CFI_CDESC_T(1) d;
+  CFI_index_t ext[1] = {4};
+  CFI_establish((CFI_cdesc_t *) &d, a, CFI_attribute_other, 
+    CFI_type_int32_t, sizeof(int), 1, ext);
+
+  EXPECT_TRUE(Fcpp_impl_::type_matches<std::int32_t>((CFI_cdesc_t *) &d));
+  EXPECT_TRUE(Fcpp_impl_::type_matches<const int>((CFI_cdesc_t *) &d));
+  EXPECT_FALSE(Fcpp_impl_::type_matches<unsigned short>((CFI_cdesc_t *) &d));
+  EXPECT_FALSE(Fcpp_impl_::type_matches<float>((CFI_cdesc_t *) &d));
+
+  // Derived types may be described as CFI_type_other or CFI_type_struct
+  d.type = CFI_type_other;
+  d.elem_len = sizeof(opaque_t);
+  EXPECT_FALSE(Fcpp_impl_::type_matches<particle_t>((CFI_cdesc_t *) &d));
+  d.elem_len = sizeof(particle_t);
+  EXPECT_TRUE(Fcpp_impl_::type_matches<particle_t>((CFI_cdesc_t *) &d));
+}
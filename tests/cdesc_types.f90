@@ -0,0 +1,30 @@
+module cdesc_types
+use, intrinsic :: iso_c_binding
+implicit none
+
+type, bind(c) :: particle
+  real(c_double) :: x, y, z
+  integer(c_int32_t) :: id
+end type
+
+contains
+
+! double sum_x(CFI_cdesc_t *p);
+real(c_double) function sum_x(p) bind(c)
+type(particle), intent(in) :: p(:)
+sum_x = sum(p%x) + sum(p%id)
+end function
+
+! int count_true(CFI_cdesc_t *b);
+integer(c_int) function count_true(b) bind(c)
+logical(c_bool), intent(in) :: b(:)
+count_true = count(b)
+end function
+
+! int64_t sum_int64(CFI_cdesc_t *a);
+integer(c_int64_t) function sum_int64(a) bind(c)
+integer(c_int64_t), intent(in) :: a(:)
+sum_int64 = sum(a)
+end function
+
+end module
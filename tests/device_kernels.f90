@@ -0,0 +1,33 @@
+! Fortran side of device_test.cc
+
+! void device_fill(CFI_cdesc_t *a, double value);
+! Runs on the device, a is in device memory
+subroutine device_fill(a,value) bind(c)
+use, intrinsic :: iso_c_binding, only: c_double
+implicit none
+real(c_double), intent(out) :: a(:)
+real(c_double), value :: value
+integer :: i
+!$omp target teams distribute parallel do has_device_addr(a)
+do i = 1, size(a)
+  a(i) = value*i
+end do
+end subroutine
+
+! void mapped_scale(double *a, int n);
+! Maps a(1::2) and lets C++ scale it on the device
+subroutine mapped_scale(a,n) bind(c)
+use, intrinsic :: iso_c_binding, only: c_double, c_int
+implicit none
+integer(c_int), value :: n
+real(c_double), intent(inout), target :: a(n)
+interface
+  subroutine device_scale(x) bind(c)
+    import :: c_double
+    real(c_double), intent(inout) :: x(:)
+  end subroutine
+end interface
+!$omp target data map(tofrom: a)
+call device_scale(a(1::2))
+!$omp end target data
+end subroutine
@@ -0,0 +1,84 @@
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Fcpp/device.h"
+using namespace Fcpp;
+
+static_assert(memory_space<omp_device_space>);
+
+extern "C" void device_fill(CFI_cdesc_t *a, double value);
+extern "C" void mapped_scale(double *a, int n);
+
+// Scale a Fortran array section mapped with !$omp target data
+extern "C" void device_scale(CFI_cdesc_t *x) {
+  cdesc_ptr<double,1> fx(x);
+  auto dx = mapped_on_device(fx);
+  EXPECT_EQ(dx.extent(0),fx.extent(0));
+  EXPECT_FALSE(dx.owns_storage());
+
+  double *p = dx.data();
+  const std::ptrdiff_t n = dx.extent(0), s = dx.get()->dim[0].sm/sizeof(double);
+#pragma omp target teams distribute parallel for is_device_ptr(p) device(dx.space().device)
+  for (std::ptrdiff_t i = 0; i < n; ++i) p[i*s] *= 10;
+}
+
+TEST(cdesc_device, roundTrip) {
+
+  std::vector<double> a(20);
+  std::iota(a.begin(),a.end(),0.0);
+  cdesc<double> fa(a);
+
+  cdesc_device<double,1,omp_device_space> d(omp_device_space{},20);
+  EXPECT_TRUE(d.is_contiguous());
+  copy(d,fa);
+
+  std::vector<double> b(20,-1.0);
+  cdesc<double> fb(b);
+  copy(fb,d);
+  EXPECT_EQ(a,b);
+
+  // Strided host arrays are staged: b(1::2) = a(1:10)
+  std::fill(b.begin(),b.end(),-1.0);
+  cdesc_device<double,1,omp_device_space> h(omp_device_space{},10);
+  copy(h,fa.section(slice{0,10}));
+  copy(fb.section(slice{0,20,2}),h);
+  for (int i = 0; i < 20; ++i) EXPECT_EQ(b[i],i % 2 ? -1.0 : i/2);
+}
+
+TEST(cdesc_device, fortranKernel) {
+
+  cdesc_device<double,1,omp_device_space> d(omp_device_space{},8);
+  device_fill(d,0.5);
+
+  std::vector<double> a(8);
+  cdesc<double> fa(a);
+  copy(fa,d);
+  for (int i = 0; i < 8; ++i) EXPECT_EQ(a[i],0.5*(i + 1));
+}
+
+TEST(cdesc_device, asyncOnStream) {
+
+  std::vector<int> a(6*5), b(6*5,0);
+  std::iota(a.begin(),a.end(),0);
+  cdesc<int,2> fa(a.data(),6,5), fb(b.data(),6,5);
+
+  device_stream stream;
+  cdesc_device<int,2,omp_device_space> d(omp_device_space{},3,5);
+  copy_async(d,fa.section(slice{0,6,2},full_extent),stream);
+  copy_async(fb.section(slice{3,6},full_extent),d,stream);
+  stream.synchronize();
+
+  // b(4:6,:) = a(1::2,:)
+  for (int j = 0; j < 5; ++j)
+    for (int i = 0; i < 3; ++i) EXPECT_EQ(fb(3+i,j),fa(2*i,j));
+  EXPECT_EQ(fb(0,0),0);
+}
+
+TEST(cdesc_device, mappedFortranArray) {
+
+  std::vector<double> a(9,1.0);
+  mapped_scale(a.data(),9);
+  for (int i = 0; i < 9; ++i) EXPECT_EQ(a[i],i % 2 ? 1.0 : 10.0);
+}
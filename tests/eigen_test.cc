@@ -0,0 +1,67 @@
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Fcpp/eigen.h"
+using namespace Fcpp;
+
+TEST(eigen, fromMap) {
+
+  std::vector<double> a(12);
+  std::iota(a.begin(),a.end(),0.0);
+  Eigen::Map<Eigen::MatrixXd> m(a.data(),3,4);
+
+  cdesc<double,2> fa(m);
+  EXPECT_EQ(fa.get()->base_addr,a.data());
+  EXPECT_TRUE(fa.is_contiguous());
+  EXPECT_EQ(fa(2,3),m(2,3));
+}
+
+TEST(eigen, fromBlockAndVector) {
+
+  Eigen::MatrixXf m(6,5);
+  for (int j = 0; j < 5; ++j)
+    for (int i = 0; i < 6; ++i) m(i,j) = 10.0f*i + j;
+
+  // m(2:5,2:4) has the leading dimension of m
+  auto b = m.block(1,1,4,3);
+  cdesc<float,2> fb(b);
+  EXPECT_EQ(fb.extent(0),4);
+  EXPECT_EQ(fb.get()->dim[1].sm,6*sizeof(float));
+  EXPECT_EQ(fb(3,2),m(4,3));
+
+  Eigen::VectorXi v = Eigen::VectorXi::LinSpaced(8,0,7);
+  cdesc<int> fv(v);
+  EXPECT_EQ(fv.extent(0),8);
+  EXPECT_EQ(fv[7],7);
+}
+
+TEST(eigen, toEigenSection) {
+
+  std::vector<double> a(7*5);
+  std::iota(a.begin(),a.end(),0.0);
+  cdesc<double,2> fa(a.data(),7,5);
+
+  // a(1::2,2:4) as a matrix with inner stride 2 and outer stride 7
+  auto s = fa.section(slice{0,7,2},slice{1,4});
+  auto m = to_eigen(s);
+  EXPECT_EQ(m.rows(),4);
+  EXPECT_EQ(m.cols(),3);
+  EXPECT_EQ(m.innerStride(),2);
+  EXPECT_EQ(m.outerStride(),7);
+  for (int j = 0; j < 3; ++j)
+    for (int i = 0; i < 4; ++i) EXPECT_EQ(m(i,j),s(i,j));
+
+  // Writes go to the array
+  m *= 2.0;
+  EXPECT_EQ(fa(6,3),2.0*(6 + 3*7));
+  EXPECT_EQ(fa(1,3),1.0 + 3*7);
+
+  // a(1,:) as a vector
+  auto v = to_eigen(fa.section(0,full_extent));
+  EXPECT_EQ(v.size(),5);
+  EXPECT_EQ(v.innerStride(),7);
+  EXPECT_EQ(v(1),14.0);
+  EXPECT_EQ(v(4),4*7.0);
+}
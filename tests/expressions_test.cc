@@ -0,0 +1,106 @@
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Fcpp/expressions.h"
+using namespace Fcpp;
+
+TEST(expressions, threeOperandUpdate) {
+
+  std::vector<double> a(37), b(37), out(37);
+  std::iota(a.begin(),a.end(),0.0);
+  std::fill(b.begin(),b.end(),1.0);
+  cdesc<double> fa(a), fb(b), fout(out);
+
+  fout = fa*2.0 + fb;
+  for (std::size_t i = 0; i < out.size(); ++i) EXPECT_EQ(out[i],2.0*i + 1.0);
+
+  // Operands may be the array being assigned
+  fout = 0.5*fout - fb/2.0;
+  for (std::size_t i = 0; i < out.size(); ++i) EXPECT_EQ(out[i],static_cast<double>(i));
+}
+
+TEST(expressions, cdescPtr) {
+
+  std::vector<float> a(8,3.0f), b(8,4.0f);
+  cdesc<float> fa(a), fb(b);
+  cdesc_ptr<float,1> pa(fa.get()), pb(fb.get());
+
+  pb = -(pa*pa) + pb*pb;
+  for (float x : b) EXPECT_EQ(x,7.0f);
+}
+
+TEST(expressions, mixedStrides) {
+
+  std::vector<int> a(20), out(10*3,0);
+  std::iota(a.begin(),a.end(),0);
+  cdesc<int> fa(a);
+  cdesc<int,2> fout(out.data(),10,3);
+
+  // out(:,2) = a(20:2:-2) + 1
+  fout.section(full_extent,1) = fa.section(slice{19,0,-2}) + 1;
+  for (int i = 0; i < 10; ++i) EXPECT_EQ(fout(i,1),20 - 2*i);
+
+  // out(3,:) = out(3,:) - a(1:3), a strided row
+  fout.section(2,full_extent) = fout.section(2,full_extent) - fa.section(slice{0,3});
+  EXPECT_EQ(fout(2,0),0);
+  EXPECT_EQ(fout(2,1),16 - 1);
+  EXPECT_EQ(fout(2,2),-2);
+}
+
+TEST(expressions, rank2Sections) {
+
+  std::vector<double> a(6*4), b(6*4), out(3*4);
+  std::iota(a.begin(),a.end(),0.0);
+  std::iota(b.begin(),b.end(),100.0);
+  cdesc<double,2> fa(a.data(),6,4), fb(b.data(),6,4), fout(out.data(),3,4);
+
+  // out = a(1::2,:) * b(4:6,:)
+  fout = fa.section(slice{0,6,2},full_extent) * fb.section(slice{3,6},full_extent);
+  for (std::size_t j = 0; j < 4; ++j)
+    for (std::size_t i = 0; i < 3; ++i)
+      EXPECT_EQ(fout(i,j),fa(2*i,j)*fb(3+i,j));
+}
+
+TEST(expressions, scalarKeepsCategory) {
+
+  std::vector<int> a{1,2,3};
+  std::vector<double> out(3);
+  cdesc<int> fa(a);
+  cdesc<double> fout(out);
+
+  // int * double is evaluated in double
+  fout = fa*2.5;
+  EXPECT_EQ(out,(std::vector<double>{2.5,5.0,7.5}));
+}
+
+TEST(expressions, map) {
+
+  std::vector<double> x{3.0, 5.0}, y{4.0, 12.0}, out(2);
+  cdesc<double> fx(x), fy(y), fout(out);
+
+  fout = Fcpp::map([](double u, double v) { return std::hypot(u,v); }, fx, fy) + 1.0;
+  EXPECT_EQ(out,(std::vector<double>{6.0,14.0}));
+}
+
+TEST(expressions, assignCopiesElements) {
+
+  std::vector<double> a{1,2,3,4,5,6}, out(3);
+  cdesc<double> fa(a), fout(out);
+
+  assign(fout,fa.section(slice{0,6,2}));
+  EXPECT_EQ(out,(std::vector<double>{1,3,5}));
+}
+
+TEST(expressions, noAliasAndConstOperands) {
+
+  const std::vector<double> a{1,2,3,4,5,6,7,8,9};
+  std::vector<double> out(9);
+  cdesc<const double> fa(a);
+  cdesc<double> fout(out);
+
+  assign(fout, fa*fa + 1.0, no_alias);
+  for (std::size_t i = 0; i < out.size(); ++i) EXPECT_EQ(out[i],a[i]*a[i] + 1.0);
+}
@@ -0,0 +1,64 @@
+#include <array>
+#include <numeric>
+
+#include <gtest/gtest.h>
+
+#include "Fcpp/fixed.h"
+#include "Fcpp/algorithms.h"
+using namespace Fcpp;
+
+extern "C" int alltwo(CFI_cdesc_t *b);
+
+using tensor = cdesc_fixed<double,extents<3,3>>;
+
+static_assert(tensor::rank() == 2);
+static_assert(tensor::extent<1>() == 3);
+static_assert(tensor::size() == 9);
+static_assert(tensor::offset(2,1) == 5);
+static_assert(std::ranges::contiguous_range<tensor>);
+
+TEST(cdesc_fixed, describesArray) {
+
+  std::array<double,9> a;
+  std::iota(a.begin(),a.end(),0.0);
+  tensor t(a);
+
+  const CFI_cdesc_t *d = t.get();
+  EXPECT_EQ(d->base_addr,a.data());
+  EXPECT_EQ(d->rank,2);
+  EXPECT_EQ(d->dim[1].extent,3);
+  EXPECT_EQ(d->dim[1].sm,3*sizeof(double));
+  EXPECT_EQ(CFI_is_contiguous(d),1);
+
+  EXPECT_EQ(t(1,2),7.0);
+  EXPECT_EQ((t.at<2,2>()),8.0);
+  EXPECT_EQ(sum(t),36.0);
+}
+
+TEST(cdesc_fixed, unrolledLoop) {
+
+  double a[3][4] = {};
+  cdesc_fixed<double,extents<4,3>> t(&a[0][0]);
+
+  // Indices visit the elements in array element order
+  int k = 0;
+  t.for_each_index([&](auto i, auto j) {
+    EXPECT_EQ(t.offset(i,j),k++);
+    t.at<i,j>() = 10*i + j;
+  });
+  EXPECT_EQ(k,12);
+  EXPECT_EQ(a[2][1],12.0);
+}
+
+TEST(cdesc_fixed, passedToFortran) {
+
+  int b[4] = {2,2,2,2};
+  cdesc_fixed<int,extents<4>> fb(b);
+  EXPECT_EQ(alltwo(fb),1);
+  fb[3] = 1;
+  EXPECT_EQ(alltwo(fb),0);
+
+  const std::array<int,4> c{2,2,2,2};
+  cdesc_fixed<const int,extents<4>> fc(c);
+  EXPECT_EQ(alltwo(fc),1);
+}
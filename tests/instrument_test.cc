@@ -0,0 +1,92 @@
+// Compiled with and without FCPP_INSTRUMENT, see CMakeLists.txt
+#include <numeric>
+#include <sstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Fcpp/instrument.h"
+using namespace Fcpp;
+
+extern "C" int alltwo(CFI_cdesc_t *b);
+
+#if FCPP_INSTRUMENT
+
+static int call_events = 0;
+static std::uint64_t last_ns = 0;
+
+static void on_event(const instrumentation_event& e) {
+  if (e.kind == event_kind::call_begin || e.kind == event_kind::call_end) {
+    ++call_events;
+    EXPECT_STREQ(e.name,"alltwo");
+  }
+  if (e.kind == event_kind::call_end) last_ns = e.nanoseconds;
+}
+
+TEST(instrumentation, countsEvents) {
+
+  reset_statistics();
+
+  std::vector<int> a(10, 2);
+  cdesc<int> fa(a);
+  EXPECT_EQ(statistics(event_kind::establish).count,1);
+  EXPECT_EQ(statistics(event_kind::establish).bytes,10*sizeof(int));
+
+  auto s = fa.section(slice{0,10,2});
+  EXPECT_EQ(statistics(event_kind::section).count,1);
+  EXPECT_EQ(statistics(event_kind::section).bytes,5*sizeof(int));
+
+  EXPECT_FALSE(s.is_contiguous());
+  EXPECT_EQ(statistics(event_kind::contiguity_check).count,1);
+
+  int sum = 0;
+  for (int x : s) sum += x;
+  EXPECT_EQ(sum,10);
+  EXPECT_EQ(statistics(event_kind::strided_iteration).count,1);
+
+  // Contiguous iteration is not counted
+  cdesc_ptr<int,1> p(fa.get());
+  for (int x : p) sum += x;
+  EXPECT_EQ(statistics(event_kind::strided_iteration).count,1);
+}
+
+TEST(instrumentation, fortranCalls) {
+
+  reset_statistics();
+  instrumentation_callback prev = set_instrumentation_callback(on_event);
+
+  std::vector<int> a(8, 2);
+  cdesc<int> fa(a);
+
+  EXPECT_EQ(FCPP_CALL(alltwo, fa), 1);
+  EXPECT_EQ(FCPP_CALL(alltwo, fa.section(slice{0,8,2})), 1);
+  EXPECT_EQ(instrumented_call("alltwo", alltwo, fa.get()), 1);
+
+  set_instrumentation_callback(prev);
+  EXPECT_EQ(call_events,6);
+  EXPECT_GT(last_ns,0u);
+
+  const auto calls = call_summary();
+  ASSERT_EQ(calls.count("alltwo"),1);
+  const auto& st = calls.at("alltwo");
+  EXPECT_EQ(st.calls,3);
+  EXPECT_EQ(st.noncontiguous_args,1);
+  EXPECT_EQ(st.bytes,(8 + 4 + 8)*sizeof(int));
+
+  std::ostringstream os;
+  write_summary(os);
+  EXPECT_NE(os.str().find("alltwo"),std::string::npos);
+  EXPECT_NE(os.str().find("strided_iteration"),std::string::npos);
+}
+
+#else
+
+TEST(instrumentation, compiledOut) {
+
+  std::vector<int> a(8, 2);
+  cdesc<int> fa(a);
+  EXPECT_EQ(FCPP_CALL(alltwo, fa), 1);
+  EXPECT_EQ(instrumented_call("alltwo", alltwo, fa.get()), 1);
+}
+
+#endif
@@ -0,0 +1,156 @@
+#include <memory_resource>
+#include <numeric>
+
+#include <gtest/gtest.h>
+
+#include "Fcpp/memory.h"
+using namespace Fcpp;
+
+TEST(cdesc_buffer_class, resizeWithinCapacity) {
+
+  cdesc_buffer<double,2> a(4,5);
+
+  EXPECT_EQ(a.rank(),2);
+  EXPECT_EQ(a.extent(0),4);
+  EXPECT_EQ(a.extent(1),5);
+  EXPECT_EQ(a.size(),20);
+  EXPECT_EQ(a.capacity(),20);
+  EXPECT_EQ(a.get()->base_addr,a.data());
+  EXPECT_TRUE(CFI_is_contiguous(a.get()));
+
+  double *p = a.data();
+  a.resize(2,10);
+  EXPECT_EQ(a.data(),p);
+  EXPECT_EQ(a.extent(0),2);
+  EXPECT_EQ(a.get()->dim[1].sm,2*sizeof(double));
+
+  a.resize(5,5);
+  EXPECT_EQ(a.capacity(),25);
+
+  auto v = a.view();
+  static_assert(std::is_same_v<decltype(v),
+    cdesc_ptr<double,2,attr::other,layout::contiguous>>);
+  v(4,4) = 3.0;
+  EXPECT_EQ(a.data()[24],3.0);
+}
+
+TEST(cdesc_buffer_class, move) {
+
+  cdesc_buffer<int> a(6);
+  std::iota(a.begin(),a.end(),0);
+  int *p = a.data();
+
+  cdesc_buffer<int> b(std::move(a));
+  EXPECT_EQ(a.data(),nullptr);
+  EXPECT_EQ(a.size(),0);
+  EXPECT_EQ(b.data(),p);
+  EXPECT_EQ(b.get()->base_addr,p);
+  EXPECT_EQ(b.view()[5],5);
+}
+
+TEST(cdesc_buffer_class, poolAllocator) {
+
+  std::pmr::unsynchronized_pool_resource pool;
+  using alloc = std::pmr::polymorphic_allocator<float>;
+
+  void *first = nullptr;
+  for (int step = 0; step < 3; ++step) {
+    cdesc_buffer<float,1,alloc> scratch{alloc(&pool)};
+    scratch.resize(64);
+    if (step == 0) {
+      first = scratch.data();
+    } else {
+      // Memory is recycled by the pool on every step
+      EXPECT_EQ(scratch.data(),first);
+    }
+  }
+}
+
+TEST(cdesc_buffer_class, moveAssignOtherResource) {
+
+  std::pmr::monotonic_buffer_resource r1, r2;
+  using alloc = std::pmr::polymorphic_allocator<double>;
+
+  cdesc_buffer<double,2,alloc> a{alloc(&r1)};
+  a.resize(3,2);
+  for (int j = 0; j < 2; ++j) {
+    for (int i = 0; i < 3; ++i) a.view()(i,j) = 10*j + i;
+  }
+  cdesc_buffer<double,2,alloc> b{alloc(&r2)};
+
+  // The storage of a cannot be freed through r2, so the elements are copied
+  b = std::move(a);
+  EXPECT_EQ(b.get_allocator().resource(),&r2);
+  EXPECT_NE(b.data(),nullptr);
+  EXPECT_EQ(b.get()->base_addr,b.data());
+  EXPECT_EQ(b.extent(0),3);
+  EXPECT_EQ(b.extent(1),2);
+  EXPECT_EQ(b.view()(2,1),12.0);
+  EXPECT_EQ(a.size(),0);
+
+  // Same resource: the storage is taken over
+  cdesc_buffer<double,2,alloc> c{alloc(&r2)};
+  double *p = b.data();
+  c = std::move(b);
+  EXPECT_EQ(c.data(),p);
+  EXPECT_EQ(b.data(),nullptr);
+}
+
+static_assert(std::is_nothrow_move_assignable_v<cdesc_buffer<float>>);
+static_assert(!std::is_nothrow_move_assignable_v<
+  cdesc_buffer<float,1,std::pmr::polymorphic_allocator<float>>>);
+
+static_assert(cdesc_buffer<float>::alignment == alignof(float));
+static_assert(cdesc_buffer<float,1,aligned_allocator<float,32>>::alignment == 32);
+
+static_assert(padded_extent<double,64>(5) == 8);
+static_assert(padded_extent<double,64>(8) == 8);
+static_assert(padded_extent<double,64>(512) == 520);
+static_assert(padded_extent<double,64>(512,false) == 512);
+static_assert(padded_extent<std::complex<double>,64>(3) == 4);
+
+TEST(aligned_allocator, alignedVector) {
+
+  aligned_vector<double,64> a(17);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a.data()) % 64, 0);
+
+  cdesc fa(a);
+  EXPECT_EQ(fa.extent(0),17);
+  EXPECT_EQ(fa.aligned_data<64>(),a.data());
+}
+
+TEST(cdesc_buffer_class, paddedLeadingDimension) {
+
+  cdesc_buffer<double,2,aligned_allocator<double,64>> a;
+  a.resize_padded(5,3);
+
+  EXPECT_EQ(a.extent(0),5);
+  EXPECT_EQ(a.extent(1),3);
+  EXPECT_EQ(a.leading_dim(),8);
+  EXPECT_EQ(a.capacity(),24);
+  EXPECT_EQ(a.get()->dim[0].sm,sizeof(double));
+  EXPECT_EQ(a.get()->dim[1].sm,8*sizeof(double));
+  EXPECT_FALSE(CFI_is_contiguous(a.get()));
+
+  // Every column starts on a 64-byte boundary
+  auto v = a.strided_view();
+  for (int j = 0; j < 3; ++j) {
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&v(0,j)) % 64, 0);
+  }
+  v(4,2) = 1.0;
+  EXPECT_EQ(a.data()[4 + 8*2],1.0);
+}
+
+TEST(cdesc_class, paddedConstructor) {
+
+  std::vector<int> a(4*3);
+  cdesc<int,2> fa(a.data(),leading_dim{4},3,3);
+
+  EXPECT_EQ(fa.extent(0),3);
+  EXPECT_EQ(fa.extent(1),3);
+  EXPECT_EQ(fa.get()->dim[1].sm,4*sizeof(int));
+  EXPECT_EQ(fa.get()->base_addr,a.data());
+
+  fa(2,2) = 9;
+  EXPECT_EQ(a[2 + 4*2],9);
+}
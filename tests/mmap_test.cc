@@ -0,0 +1,136 @@
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Fcpp/mmap.h"
+using namespace Fcpp;
+
+extern "C" int alltwo(CFI_cdesc_t *b);
+
+class mapped_array_class : public ::testing::Test {
+protected:
+  void SetUp() override {
+    dir_ = std::filesystem::temp_directory_path() / 
+      ("fcpp_mmap_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(dir_);
+  }
+  void TearDown() override { std::filesystem::remove_all(dir_); }
+
+  std::string path(const char *name) const { return (dir_ / name).string(); }
+
+  std::filesystem::path dir_;
+};
+
+TEST_F(mapped_array_class, openRaw) {
+
+  std::vector<double> a(4*3);
+  std::iota(a.begin(),a.end(),0.0);
+  {
+    std::ofstream f(path("raw.bin"), std::ios::binary);
+    const char pad[16] = {};
+    f.write(pad, sizeof(pad));
+    f.write(reinterpret_cast<const char *>(a.data()), a.size()*sizeof(double));
+  }
+
+  auto m = mapped_array<double,2>::open_raw(path("raw.bin"), {4,3}, 
+    {.hint = access_hint::sequential}, 16);
+  EXPECT_EQ(m.extent(0),4);
+  EXPECT_EQ(m.extent(1),3);
+  EXPECT_TRUE(CFI_is_contiguous(m.get()));
+  EXPECT_EQ(m.view()(3,2),11.0);
+  EXPECT_TRUE(std::equal(m.begin(),m.end(),a.begin()));
+}
+
+TEST_F(mapped_array_class, rawFileTooSmall) {
+  {
+    std::ofstream f(path("small.bin"), std::ios::binary);
+    f << "abc";
+  }
+  EXPECT_THROW((mapped_array<double>::open_raw(path("small.bin"), {4})), std::runtime_error);
+  EXPECT_THROW((mapped_array<double>::open_raw(path("missing.bin"), {4})), std::system_error);
+}
+
+TEST_F(mapped_array_class, saveAndOpen) {
+
+  std::vector<int> a(6*5, 2);
+  cdesc<int,2> fa(a.data(),6,5);
+  fa(1,1) = 7;
+
+  // A strided section is packed into the file
+  save_array(path("a.arr"), fa.section(slice{1,6,2},full_extent));
+
+  auto m = mapped_array<int,2>::open(path("a.arr"), {.huge_pages = true});
+  EXPECT_EQ(m.extent(0),3);
+  EXPECT_EQ(m.extent(1),5);
+  EXPECT_EQ(m.view()(0,1),7);
+}
+
+TEST_F(mapped_array_class, headerMismatch) {
+
+  std::vector<int> a(8, 2);
+  save_array(path("b.arr"), cdesc<int>(a));
+
+  EXPECT_THROW((mapped_array<float>::open(path("b.arr"))), std::runtime_error);
+  EXPECT_THROW((mapped_array<int,2>::open(path("b.arr"))), std::runtime_error);
+
+  auto m = mapped_array<int>::open(path("b.arr"));
+  EXPECT_EQ(alltwo(m),1);
+}
+
+TEST_F(mapped_array_class, corruptHeader) {
+
+  std::vector<double> a(8, 1.0);
+  save_array(path("c.arr"), cdesc<double>(a));
+
+  // Overwrite one header field in place and try to open the file
+  auto patched = [&](std::size_t field, std::int64_t value) {
+    std::fstream f(path("c.arr"), std::ios::binary | std::ios::in | std::ios::out);
+    f.seekp(field);
+    f.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    f.close();
+    return mapped_array<double>::open(path("c.arr"));
+  };
+  const std::size_t offset = offsetof(array_file_header, data_offset);
+  const std::size_t extent = offsetof(array_file_header, extent);
+
+  EXPECT_THROW(patched(extent, -8), std::runtime_error);
+  EXPECT_THROW(patched(extent, std::int64_t(1) << 61), std::runtime_error); // wraps n*sizeof(T)
+  EXPECT_THROW(patched(extent, 9), std::runtime_error);                     // past the end
+  patched(extent, 8);
+
+  EXPECT_THROW(patched(offset, 4097), std::runtime_error);                  // misaligned
+  EXPECT_THROW(patched(offset, 0), std::runtime_error);                     // inside the header
+  EXPECT_THROW(patched(offset, std::int64_t(1) << 40), std::runtime_error);
+  EXPECT_EQ(patched(offset, 4096).view()[7], 1.0);
+}
+
+TEST_F(mapped_array_class, createSharedAndCopyOnWrite) {
+  {
+    auto out = mapped_array<int>::create(path("c.arr"), {100});
+    std::fill(out.begin(),out.end(),2);
+    out.sync();
+  }
+  {
+    auto cow = mapped_array<int>::open(path("c.arr"), {.mode = map_mode::copy_on_write});
+    cow.data()[0] = 5;
+    EXPECT_EQ(alltwo(cow),0);
+  }
+  auto m = mapped_array<int>::open(path("c.arr"));
+  EXPECT_EQ(m.size(),100);
+  EXPECT_EQ(alltwo(m),1);
+
+  mapped_array<int> moved(std::move(m));
+  EXPECT_EQ(moved.data()[99],2);
+}
+
+TEST_F(mapped_array_class, emptyArray) {
+
+  auto out = mapped_array<double,2>::create(path("e.arr"), {0,3});
+  EXPECT_EQ(out.size(),0);
+  auto m = mapped_array<double,2>::open(path("e.arr"));
+  EXPECT_EQ(m.extent(1),3);
+}
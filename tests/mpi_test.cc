@@ -0,0 +1,83 @@
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Fcpp/mpi.h"
+using namespace Fcpp;
+
+// Messages to the process itself on MPI_COMM_SELF; they are small
+// enough to be buffered, so that send returns before recv is posted
+
+TEST(mpi, contiguousRoundTrip) {
+
+  std::vector<double> a(5*4);
+  std::iota(a.begin(),a.end(),0.0);
+  cdesc<double,2> fa(a.data(),5,4);
+  send(fa,0,1,MPI_COMM_SELF);
+
+  std::vector<double> b(5*4);
+  recv(cdesc<double,2>(b.data(),5,4),MPI_ANY_SOURCE,1,MPI_COMM_SELF);
+  EXPECT_EQ(a,b);
+}
+
+TEST(mpi, stridedWithoutPacking) {
+
+  std::vector<int> a(6*5);
+  std::iota(a.begin(),a.end(),0);
+  cdesc<int,2> fa(a.data(),6,5);
+
+  // a(6:1:-2,2::2) sent straight from the array into b(1::2,:)
+  auto s = fa.section(slice{5,-1,-2},slice{1,5,2});
+  send(s,0,2,MPI_COMM_SELF);
+
+  std::vector<int> b(6*2,-1);
+  cdesc<int,2> fb(b.data(),6,2);
+  recv(fb.section(slice{0,6,2},full_extent),0,2,MPI_COMM_SELF);
+  for (std::size_t j = 0; j < 2; ++j)
+    for (std::size_t i = 0; i < 3; ++i) {
+      EXPECT_EQ(fb(2*i,j),s(i,j));
+      EXPECT_EQ(fb(2*i+1,j),-1);
+    }
+}
+
+TEST(mpi, datatypeOfSection) {
+
+  std::vector<double> a(4*4*3);
+  std::iota(a.begin(),a.end(),0.0);
+  cdesc<double,3> fa(a.data(),4,4,3);
+  auto s = fa.section(slice{0,4,3},slice{1,3},full_extent);
+
+  mpi_datatype t = make_datatype(s);
+  int bytes = 0;
+  MPI_Type_size(t,&bytes);
+  EXPECT_EQ(bytes,static_cast<int>(s.size()*sizeof(double)));
+
+  // Received as contiguous elements, in array element order
+  std::vector<double> b(s.size());
+  MPI_Sendrecv(s.get()->base_addr,1,t,0,3,b.data(),static_cast<int>(b.size()),MPI_DOUBLE,
+               0,3,MPI_COMM_SELF,MPI_STATUS_IGNORE);
+  std::size_t k = 0;
+  for (std::size_t l = 0; l < 3; ++l)
+    for (std::size_t j = 0; j < 2; ++j)
+      for (std::size_t i = 0; i < 2; ++i) EXPECT_EQ(b[k++],s(i,j,l));
+}
+
+TEST(mpi, extentMismatch) {
+
+  std::vector<float> a(3,1.0f);
+  send(cdesc<float>(a.data(),3),0,4,MPI_COMM_SELF);
+
+  std::vector<float> b(4);
+  EXPECT_THROW(recv(cdesc<float>(b.data(),4),0,4,MPI_COMM_SELF),std::runtime_error);
+  // Drain the elements that were not received
+  MPI_Recv(a.data(),3,MPI_FLOAT,0,4,MPI_COMM_SELF,MPI_STATUS_IGNORE);
+}
+
+int main(int argc, char **argv) {
+  MPI_Init(&argc,&argv);
+  ::testing::InitGoogleTest(&argc,argv);
+  const int result = RUN_ALL_TESTS();
+  MPI_Finalize();
+  return result;
+}
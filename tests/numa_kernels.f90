@@ -0,0 +1,22 @@
+! void static_owner(CFI_cdesc_t *a, int chunk);
+subroutine static_owner(a,chunk) bind(c)
+use, intrinsic :: iso_c_binding, only: c_int
+use omp_lib, only: omp_get_thread_num
+implicit none
+integer(c_int), intent(out) :: a(:,:)
+integer(c_int), value :: chunk
+integer :: j
+if (chunk > 0) then
+  !$omp parallel do schedule(static,chunk)
+  do j = 1, size(a,2)
+    a(:,j) = omp_get_thread_num()
+  end do
+  !$omp end parallel do
+else
+  !$omp parallel do schedule(static)
+  do j = 1, size(a,2)
+    a(:,j) = omp_get_thread_num()
+  end do
+  !$omp end parallel do
+end if
+end subroutine
@@ -0,0 +1,100 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Fcpp/numa.h"
+using namespace Fcpp;
+
+extern "C" void static_owner(CFI_cdesc_t *a, int chunk);
+
+// Owner thread of each iteration according to static_blocks
+static std::vector<int> owners(std::size_t n, int p, std::size_t chunk) {
+  std::vector<int> o(n,-1);
+  for (int t = 0; t < p; ++t) {
+    Fcpp_impl_::static_blocks(n, p, chunk, t, [&](std::size_t b, std::size_t e) {
+      for (std::size_t i = b; i < e; ++i) o[i] = t;
+    });
+  }
+  return o;
+}
+
+TEST(static_schedule, matchesFortranOpenMP) {
+
+  const int p = 4;
+  omp_set_num_threads(p);
+
+  for (std::size_t chunk : {0, 1, 3}) {
+    for (int n : {1, 7, 13, 64}) {
+      std::vector<int> a(2*n,-1);
+      static_owner(cdesc<int,2>(a.data(),2,n), static_cast<int>(chunk));
+
+      const auto o = owners(n, p, chunk);
+      for (int j = 0; j < n; ++j) {
+        EXPECT_EQ(a[2*j], o[j]) << "n = " << n << ", chunk = " << chunk;
+      }
+    }
+  }
+}
+
+TEST(first_touch, fillsAllElements) {
+
+  const std::size_t nx = 5, ny = 11;
+  auto a = make_first_touch_vector<double>(nx*ny, {.num_threads = 3, .inner = nx}, 1.5);
+
+  EXPECT_EQ(a.size(), nx*ny);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a.data()) % 4096, 0);
+  for (double x : a) EXPECT_EQ(x, 1.5);
+
+  cdesc<double,2> fa(a.data(), nx, ny);
+  EXPECT_EQ(fa(4,10), 1.5);
+
+  first_touch(std::span<double>(a), {.num_threads = 2, .chunk = 2}, 0.0);
+  for (double x : a) EXPECT_EQ(x, 0.0);
+}
+
+TEST(first_touch, smallerTeam) {
+
+  // Within an active region the nested team has a single thread
+  const int levels = omp_get_max_active_levels();
+  omp_set_max_active_levels(1);
+
+  std::vector<int> a(8,-1);
+  #pragma omp parallel num_threads(2)
+  {
+    #pragma omp single
+    first_touch(std::span<int>(a), {.num_threads = 4}, 1);
+  }
+  omp_set_max_active_levels(levels);
+
+  for (int x : a) EXPECT_EQ(x, 1);
+}
+
+TEST(first_touch_allocator, leavesElementsUninitialized) {
+  
+  first_touch_vector<int> v;
+  v.reserve(4);
+  v.push_back(3);
+  v.resize(4);         // default-initialized, not zeroed
+  EXPECT_EQ(v[0], 3);
+  v.resize(6, 7);
+  EXPECT_EQ(v[5], 7);
+
+  static_assert(std::is_same_v<
+    std::allocator_traits<first_touch_allocator<int>>::rebind_alloc<double>,
+    first_touch_allocator<double>>);
+}
+
+#if defined(FCPP_USE_LIBNUMA)
+TEST(numa_placement, bindAndInterleave) {
+
+  first_touch_vector<double> a(1 << 16);
+  try {
+    numa_bind(std::span<double>(a), 0);
+    numa_interleave(std::span<double>(a));
+  } catch (const std::system_error& e) {
+    GTEST_SKIP() << "mbind not permitted: " << e.what();
+  }
+  first_touch(std::span<double>(a), {.num_threads = 2});
+  EXPECT_EQ(a.back(), 0.0);
+}
+#endif
@@ -0,0 +1,123 @@
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Fcpp/pack.h"
+using namespace Fcpp;
+
+TEST(pack, stridedSection) {
+
+  std::vector<int> a(10);
+  std::iota(a.begin(),a.end(),0);
+  cdesc<int> fa(a.data(),10);
+
+  std::vector<int> b(5);
+  EXPECT_EQ(pack(fa.section(slice{1,10,2}),b.data()),5);
+  EXPECT_EQ(b,(std::vector<int>{1,3,5,7,9}));
+
+  EXPECT_EQ(pack(fa.section(slice{4,-1,-1}),b.data()),5);
+  EXPECT_EQ(b,(std::vector<int>{4,3,2,1,0}));
+}
+
+TEST(pack, elementOrderRank3) {
+
+  std::vector<int> a(4*3*2);
+  std::iota(a.begin(),a.end(),0);
+  cdesc<int,3> fa(a.data(),4,3,2);
+
+  // a(1::2,:,:)
+  auto s = fa.section(slice{0,4,2},full_extent,full_extent);
+  std::vector<int> b(s.size());
+  pack(s,b.data());
+
+  std::size_t k = 0;
+  for (std::size_t l = 0; l < 2; ++l)
+    for (std::size_t j = 0; j < 3; ++j)
+      for (std::size_t i = 0; i < 2; ++i) EXPECT_EQ(b[k++], s(i,j,l));
+}
+
+TEST(pack, columnBlock) {
+
+  std::vector<double> a(5*6);
+  std::iota(a.begin(),a.end(),0.0);
+  cdesc<double,2> fa(a.data(),5,6);
+
+  // a(:,2:4) is contiguous and copied as one run
+  std::vector<double> b(15);
+  pack(fa.section(full_extent,slice{1,4}),b.data());
+  EXPECT_TRUE(std::equal(b.begin(),b.end(),a.begin()+5));
+}
+
+TEST(unpack, roundTrip) {
+
+  std::vector<int> a(6*4,0);
+  cdesc<int,2> fa(a.data(),6,4);
+  auto s = fa.section(slice{5,-1,-2},slice{0,4,3});
+
+  std::vector<int> b(s.size());
+  std::iota(b.begin(),b.end(),1);
+  EXPECT_EQ(unpack(b.data(),s),6);
+
+  std::vector<int> c(b.size());
+  pack(s,c.data());
+  EXPECT_EQ(b,c);
+  EXPECT_EQ(std::accumulate(a.begin(),a.end(),0),21);
+}
+
+TEST(staged, copyInCopyOut) {
+
+  std::vector<double> a(8);
+  std::iota(a.begin(),a.end(),0.0);
+  cdesc<double> fa(a.data(),8);
+
+  std::vector<double> scratch;
+  {
+    staged s(fa.section(slice{0,8,2}),scratch);
+    EXPECT_TRUE(s.is_copy());
+    EXPECT_EQ(s.data(),scratch.data());
+
+    auto v = s.view();
+    EXPECT_TRUE(v.is_contiguous());
+    EXPECT_EQ(v.size(),4);
+    for (auto &x : v) x *= 10;
+    EXPECT_EQ(a[2],2.0);
+  }
+  EXPECT_EQ(a,(std::vector<double>{0,1,20,3,40,5,60,7}));
+}
+
+TEST(staged, copyBackDisabled) {
+
+  std::vector<double> a(8,1.0);
+  cdesc<double> fa(a.data(),8);
+  std::vector<double> scratch;
+  {
+    staged s(fa.section(slice{0,8,2}),scratch,copy_back::no);
+    for (auto &x : s.view()) x = 0;
+  }
+  EXPECT_EQ(a,std::vector<double>(8,1.0));
+}
+
+TEST(staged, contiguousInPlace) {
+
+  std::vector<double> a(6);
+  cdesc<double,2> fa(a.data(),3,2);
+  std::vector<double> scratch;
+
+  staged s(fa,scratch);
+  EXPECT_FALSE(s.is_copy());
+  EXPECT_EQ(s.data(),a.data());
+  EXPECT_TRUE(scratch.empty());
+}
+
+TEST(staged, scratchIsReused) {
+
+  std::vector<int> a(20);
+  cdesc<int> fa(a.data(),20);
+  std::vector<int> scratch;
+
+  { staged s(fa.section(slice{0,20,2}),scratch); }
+  const int *p = scratch.data();
+  { staged s(fa.section(slice{0,20,4}),scratch); EXPECT_EQ(s.data(),p); }
+  { staged s(fa.section(slice{1,20,2}),scratch); EXPECT_EQ(s.data(),p); }
+}
@@ -0,0 +1,132 @@
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Fcpp/memory.h"
+#include "Fcpp/parallel.h"
+using namespace Fcpp;
+
+TEST(thread_pool, runsEachTaskOnce) {
+
+  thread_pool pool(4);
+  EXPECT_EQ(pool.size(),4u);
+
+  std::vector<std::atomic<int>> count(1000);
+  pool(count.size(), [&](std::size_t i) { count[i]++; });
+  for (auto& c : count) EXPECT_EQ(c.load(),1);
+
+  // The pool can be reused
+  pool(count.size(), [&](std::size_t i) { count[i]++; });
+  for (auto& c : count) EXPECT_EQ(c.load(),2);
+}
+
+TEST(thread_pool, stealsFromBlockedThread) {
+
+  thread_pool pool(4);
+  std::atomic<int> done{0};
+
+  // Task 0 waits for all the others, which includes the rest of its 
+  // block (tasks 1-15); these can only run if other threads steal them
+  bool all_done = false;
+  pool(64, [&](std::size_t i) {
+    if (i == 0) {
+      auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+      while (done.load() < 63 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      all_done = done.load() == 63;
+    } else {
+      done++;
+    }
+  });
+  EXPECT_TRUE(all_done);
+}
+
+TEST(thread_pool, rethrowsAndNests) {
+
+  thread_pool pool(3);
+  EXPECT_THROW(pool(10, [](std::size_t i) {
+    if (i == 7) throw std::runtime_error("task");
+  }), std::runtime_error);
+
+  // A loop inside a task runs in that task
+  std::atomic<int> n{0};
+  pool(4, [&](std::size_t) { pool(5, [&](std::size_t) { n++; }); });
+  EXPECT_EQ(n.load(),20);
+}
+
+TEST(parallel_for, stridedRank2Section) {
+
+  const int m = 301, n = 257;
+  std::vector<double> a(m*n);
+  std::iota(a.begin(),a.end(),0.0);
+  cdesc<double,2> fa(a.data(),m,n);
+
+  // a(2::3,:) = 2*a(2::3,:)
+  auto s = fa.section(slice{1,m,3},full_extent);
+  parallel_for(s, [](double& x) { x *= 2; }, {.grain = 100});
+
+  for (int j = 0; j < n; ++j)
+    for (int i = 0; i < m; ++i)
+      EXPECT_EQ(fa(i,j),(i % 3 == 1 ? 2.0 : 1.0)*(i + j*m));
+}
+
+TEST(parallel_for, chunksDoNotShareCacheLines) {
+
+  // Columns of 13 doubles are not multiples of a cache line, and
+  // the gaps of the padded columns are not either
+  aligned_vector<double> a(19*40);
+  cdesc<double,2> fa(a.data(),19,40);
+  auto s = fa.section(slice{0,13},full_extent);
+
+  const auto plan = Fcpp_impl_::plan_chunks<2>(s.get(),20);
+  ASSERT_GT(plan.bounds.size(),3u);
+  for (std::size_t k = 1; k + 1 < plan.bounds.size(); ++k) {
+    const CFI_index_t p = plan.bounds[k];
+    const auto last = reinterpret_cast<std::uintptr_t>(&a[plan.offset(p-1)]) + sizeof(double) - 1;
+    const auto first = reinterpret_cast<std::uintptr_t>(&a[plan.offset(p)]);
+    EXPECT_LT(last/FCPP_CACHE_LINE_BYTES,first/FCPP_CACHE_LINE_BYTES);
+    EXPECT_GE(p - plan.bounds[k-1],20);
+  }
+  EXPECT_EQ(plan.bounds.back(),13*40);
+}
+
+TEST(parallel_reduce, sumIsDeterministic) {
+
+  std::vector<double> a(100000);
+  for (std::size_t i = 0; i < a.size(); ++i) a[i] = 1.0/(i + 1);
+  cdesc<double> fa(a);
+
+  auto plus = [](double x, double y) { return x + y; };
+  thread_pool pool(4);
+  const double r1 = parallel_reduce(pool, fa, 0.0, plus);
+  const double r2 = parallel_reduce(sequential_executor{}, fa, 0.0, plus);
+  EXPECT_EQ(r1,r2);
+  EXPECT_NEAR(r1,std::accumulate(a.begin(),a.end(),0.0),1e-9);
+}
+
+TEST(parallel_reduce, customExecutorAndEmpty) {
+
+  std::vector<int> a(1000);
+  std::iota(a.begin(),a.end(),1);
+  cdesc<int> fa(a);
+
+  // Any callable ex(n, g) can run the chunks
+  std::size_t chunks = 0;
+  auto ex = [&](std::size_t n, auto&& g) {
+    chunks = n;
+    for (std::size_t i = n; i-- > 0; ) g(i);
+  };
+  auto maxop = [](int x, int y) { return std::max(x,y); };
+  EXPECT_EQ(parallel_reduce(ex, fa.section(slice{999,-1,-1}), 0, maxop, {.grain = 64}), 1000);
+  EXPECT_GT(chunks,1u);
+
+  std::vector<int> empty;
+  cdesc<int> fe(empty);
+  EXPECT_EQ(parallel_reduce(fe, -1, maxop), -1);
+}
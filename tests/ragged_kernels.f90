@@ -0,0 +1,19 @@
+! void ragged_row_sums(CFI_cdesc_t *values, CFI_cdesc_t *offsets, CFI_cdesc_t *sums);
+subroutine ragged_row_sums(values,offsets,sums) bind(c)
+use, intrinsic :: iso_c_binding, only: c_int
+implicit none
+integer(c_int), intent(in) :: values(:), offsets(:)
+integer(c_int), intent(out) :: sums(:)
+integer :: i
+do i = 1, size(offsets) - 1
+  sums(i) = sum(values(offsets(i)+1:offsets(i+1)))
+end do
+end subroutine
+
+! int ragged_row_size(CFI_cdesc_t *row);
+integer(c_int) function ragged_row_size(row) bind(c)
+use, intrinsic :: iso_c_binding, only: c_int
+implicit none
+integer(c_int), intent(in) :: row(:)
+ragged_row_size = size(row)
+end function
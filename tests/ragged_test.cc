@@ -0,0 +1,82 @@
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Fcpp/ragged.h"
+using namespace Fcpp;
+
+extern "C" {
+  void ragged_row_sums(CFI_cdesc_t *values, CFI_cdesc_t *offsets, CFI_cdesc_t *sums);
+  int ragged_row_size(CFI_cdesc_t *row);
+}
+
+static const std::vector<std::vector<int>> adjacency = {
+  {1, 2}, {0, 2, 3}, {}, {1}, {0, 1, 2, 3}};
+
+TEST(ragged_array_class, fromNestedVectors) {
+
+  ragged_array r(adjacency);
+  static_assert(std::is_same_v<decltype(r),ragged_array<int>>);
+
+  ASSERT_EQ(r.size(),adjacency.size());
+  EXPECT_EQ(r.num_values(),10);
+  EXPECT_EQ(r.offsets_vector(),(std::vector<int>{0,2,5,5,6,10}));
+
+  for (std::size_t i = 0; i < r.size(); ++i) {
+    EXPECT_EQ(r.row_size(i),adjacency[i].size());
+    EXPECT_TRUE(std::ranges::equal(r[i],adjacency[i]));
+  }
+}
+
+TEST(ragged_array_class, rowDescriptors) {
+
+  ragged_array<int> r(adjacency);
+
+  auto row = r.row(1);
+  EXPECT_EQ(row.extent(0),3);
+  EXPECT_EQ(row.data(),r[1].data());
+  EXPECT_EQ(row(2),3);
+
+  for (std::size_t i = 0; i < r.size(); ++i) {
+    EXPECT_EQ(ragged_row_size(r.row(i)),adjacency[i].size());
+  }
+}
+
+TEST(ragged_array_class, csrToFortran) {
+
+  ragged_array<int> r(adjacency);
+
+  std::vector<int> sums(r.size());
+  ragged_row_sums(r.values(),r.offsets(),cdesc(sums));
+
+  for (std::size_t i = 0; i < r.size(); ++i) {
+    EXPECT_EQ(sums[i],std::accumulate(adjacency[i].begin(),adjacency[i].end(),0));
+  }
+}
+
+TEST(ragged_array_class, pushBackAndRows) {
+
+  ragged_array<double> r;
+  EXPECT_TRUE(r.empty());
+  EXPECT_EQ(r.values().extent(0),0);
+
+  r.push_back({1.0, 2.0});
+  r.push_back(std::vector<double>{});
+  r.push_back({3.0});
+
+  std::size_t n = 0;
+  for (auto row : r.rows()) n += row.size();
+  EXPECT_EQ(n,3);
+
+  r.clear();
+  EXPECT_EQ(r.size(),0);
+  EXPECT_EQ(r.offsets().extent(0),1);
+}
+
+TEST(ragged_array_class, fromCsrArrays) {
+
+  ragged_array<int> r(std::vector<int>{5,6,7}, std::vector<int>{0,1,3});
+  EXPECT_EQ(r.size(),2);
+  EXPECT_EQ(r[1][1],7);
+}
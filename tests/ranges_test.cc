@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <execution>
+#include <numeric>
+#include <ranges>
+
+#include <gtest/gtest.h>
+
+#include "Fcpp.h"
+using namespace Fcpp;
+
+using strided_t = cdesc_ptr<double,1>;
+using contiguous_t = cdesc_ptr<double,1,attr::other,layout::contiguous>;
+
+static_assert(std::ranges::random_access_range<strided_t>);
+static_assert(std::ranges::sized_range<strided_t>);
+static_assert(std::ranges::borrowed_range<strided_t>);
+static_assert(std::ranges::view<strided_t>);
+static_assert(!std::ranges::contiguous_range<strided_t>);
+
+static_assert(std::ranges::contiguous_range<contiguous_t>);
+static_assert(std::ranges::view<contiguous_t>);
+
+static_assert(std::ranges::contiguous_range<cdesc<double>>);
+static_assert(std::ranges::contiguous_range<const cdesc<double>>);
+static_assert(std::ranges::contiguous_range<cdesc<const double>>);
+static_assert(std::ranges::random_access_range<cdesc_ptr<const double,1>>);
+static_assert(std::ranges::borrowed_range<cdesc<double>>);
+static_assert(!std::ranges::borrowed_range<cdesc<double,1,attr::allocatable>>);
+
+static_assert(std::ranges::random_access_range<cdesc_view<double,1>>);
+static_assert(std::ranges::view<cdesc_view<double,1>>);
+
+// Arrays of higher rank are not ranges
+static_assert(!std::ranges::range<cdesc_ptr<double,2>>);
+
+TEST(ranges, rangeAccessors) {
+
+  std::vector<double> a = {4.,3.,2.,1.,0.,-1.};
+  cdesc fa(a);
+  auto sec = fa.section(slice{0,6,2});
+  strided_t s(sec.get());
+
+  EXPECT_EQ(std::ranges::size(s),3);
+  EXPECT_EQ(std::ranges::distance(s),3);
+  EXPECT_EQ(std::ranges::data(fa),a.data());
+  EXPECT_FALSE(std::ranges::empty(s));
+
+  std::ranges::sort(s);
+  EXPECT_EQ(a,(std::vector<double>{0.,3.,2.,1.,4.,-1.}));
+
+  // Borrowed ranges can be returned from temporaries
+  auto it = std::ranges::max_element(strided_t(fa.get()));
+  EXPECT_EQ(*it,4.0);
+
+  // Composition with range adaptors
+  auto neg = contiguous_t(fa.get()) | std::views::filter([](double x) { return x < 0; });
+  EXPECT_EQ(std::ranges::distance(neg),1);
+}
+
+TEST(ranges, parallelAlgorithms) {
+
+  const int n = 10000;
+  std::vector<double> a(2*n,1.0);
+  cdesc fa(a);
+
+  // Every other element, a(1::2)
+  auto sec = fa.section(slice{0,2*n,2});
+  strided_t s(sec.get());
+
+  std::for_each(std::execution::par_unseq,s.begin(),s.end(),[](double& x) { x = 2.0; });
+  EXPECT_EQ(std::count(a.begin(),a.end(),2.0),n);
+
+  double sum = std::transform_reduce(std::execution::par_unseq,
+      s.begin(),s.end(),0.0,std::plus<>{},[](double x) { return x*x; });
+  EXPECT_EQ(sum,4.0*n);
+
+  contiguous_t c(fa.get());
+  std::transform(std::execution::par_unseq,c.begin(),c.end(),c.begin(),
+      [](double x) { return x + 1.0; });
+  EXPECT_EQ(std::reduce(std::execution::par,c.begin(),c.end()),5.0*n);
+}
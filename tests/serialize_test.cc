@@ -0,0 +1,133 @@
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "Fcpp/serialize.h"
+using namespace Fcpp;
+
+TEST(serialize, roundTrip) {
+
+  std::vector<double> a(4*3);
+  std::iota(a.begin(),a.end(),0.0);
+  cdesc<double,2> fa(a.data(),4,3);
+
+  auto buf = serialize(fa);
+  EXPECT_EQ(buf.size(),serialized_size(fa));
+  EXPECT_EQ(buf.size() % 16, 0u);
+
+  std::vector<double> b(4*3);
+  cdesc<double,2> fb(b.data(),4,3);
+  deserialize(buf.data(),buf.size(),fb);
+  EXPECT_EQ(a,b);
+
+  auto v = serialized_view<double,2>(buf.data(),buf.size());
+  EXPECT_EQ(v.extent(0),4);
+  EXPECT_EQ(v.extent(1),3);
+  EXPECT_EQ(v(3,2),11.0);
+  EXPECT_EQ(static_cast<const void *>(v.data()),
+            static_cast<const void *>(buf.data() + (buf.size() - 12*sizeof(double))));
+}
+
+TEST(serialize, stridedSectionIsPacked) {
+
+  std::vector<int> a(6*4);
+  std::iota(a.begin(),a.end(),0);
+  cdesc<int,2> fa(a.data(),6,4);
+
+  // a(2::2,:) becomes a contiguous 3 x 4 payload
+  auto s = fa.section(slice{1,6,2},full_extent);
+  auto buf = serialize(s);
+  auto v = serialized_view<int,2>(buf.data(),buf.size());
+  EXPECT_TRUE(CFI_is_contiguous(v.get()));
+  for (std::size_t j = 0; j < 4; ++j)
+    for (std::size_t i = 0; i < 3; ++i) EXPECT_EQ(v(i,j),s(i,j));
+
+  // and is unpacked into a strided destination
+  std::vector<int> b(6*4,-1);
+  cdesc<int,2> fb(b.data(),6,4);
+  deserialize(buf.data(),buf.size(),fb.section(slice{0,6,2},full_extent));
+  for (std::size_t j = 0; j < 4; ++j)
+    for (std::size_t i = 0; i < 3; ++i) {
+      EXPECT_EQ(fb(2*i,j),s(i,j));
+      EXPECT_EQ(fb(2*i+1,j),-1);
+    }
+}
+
+TEST(serialize, mismatches) {
+
+  std::vector<std::complex<float>> a(5);
+  cdesc<std::complex<float>> fa(a.data(),5);
+  auto buf = serialize(fa);
+
+  EXPECT_THROW((serialized_view<std::complex<double>,1>(buf.data(),buf.size())),std::runtime_error);
+  EXPECT_THROW((serialized_view<std::complex<float>,2>(buf.data(),buf.size())),std::runtime_error);
+  EXPECT_THROW((serialized_view<std::complex<float>,1>(buf.data(),buf.size()-1)),std::runtime_error);
+
+  std::vector<std::complex<float>> b(4);
+  EXPECT_THROW(deserialize(buf.data(),buf.size(),cdesc<std::complex<float>>(b.data(),4)),
+               std::runtime_error);
+
+  // Extents that wrap the payload size, or do not fit the view
+  auto patched = buf;
+  const std::int64_t huge = std::int64_t(1) << 62;
+  std::memcpy(patched.data() + sizeof(array_message_header), &huge, sizeof(huge));
+  EXPECT_THROW((serialized_view<std::complex<float>,1>(patched.data(),patched.size())),
+               std::runtime_error);
+
+  std::vector<std::byte> big(8192);
+  std::vector<char> c(1);
+  serialize_header(cdesc<char>(c.data(),1),big.data());
+  const std::int64_t wide = std::int64_t(1) << 32;
+  std::memcpy(big.data() + sizeof(array_message_header), &wide, sizeof(wide));
+  // (the claimed size is only compared, the payload is not read)
+  EXPECT_THROW((serialized_view<char,1>(big.data(),std::size_t(1) << 33)),std::runtime_error);
+
+  buf[0] = std::byte{'X'};
+  EXPECT_THROW((serialized_view<std::complex<float>,1>(buf.data(),buf.size())),std::runtime_error);
+}
+
+TEST(serialize, sharedSegmentBetweenProcesses) {
+
+  const std::string name = "/fcpp_serialize_" + std::to_string(::getpid());
+  std::vector<double> a(8);
+  std::iota(a.begin(),a.end(),1.0);
+  cdesc<double> fa(a.data(),8);
+
+  shared_segment s = publish(name,fa);
+  EXPECT_EQ(s.size(),serialized_size(fa));
+
+  // The child process reads the array in place and doubles it
+  const pid_t pid = ::fork();
+  ASSERT_GE(pid,0);
+  if (pid == 0) {
+    int code = 1;
+    try {
+      shared_segment t = shared_segment::open(name,true);
+      auto v = serialized_view<double,1>(t.data(),t.size());
+      double *p = const_cast<double *>(v.data());
+      for (std::size_t i = 0; i < v.size(); ++i) p[i] *= 2;
+      code = v(7) == 16.0 ? 0 : 2;
+    } catch (...) {}
+    ::_exit(code);
+  }
+  int status = 0;
+  ::waitpid(pid,&status,0);
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status),0);
+
+  std::vector<double> b(8);
+  deserialize(s.data(),s.size(),cdesc<double>(b.data(),8));
+  EXPECT_EQ(b[0],2.0);
+  EXPECT_EQ(b[7],16.0);
+
+  shared_segment::unlink(name);
+  EXPECT_THROW(shared_segment::open(name),std::system_error);
+}
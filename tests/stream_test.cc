@@ -0,0 +1,156 @@
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Fcpp/stream.h"
+using namespace Fcpp;
+
+extern "C" int alltwo(CFI_cdesc_t *b);
+
+class stream_test : public ::testing::Test {
+protected:
+  void SetUp() override {
+    dir_ = std::filesystem::temp_directory_path() / 
+      ("fcpp_stream_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(dir_);
+  }
+  void TearDown() override { std::filesystem::remove_all(dir_); }
+
+  std::string path(const char *name) const { return (dir_ / name).string(); }
+
+  std::filesystem::path dir_;
+};
+
+TEST_F(stream_test, readChunks) {
+
+  std::vector<double> a(3*10);
+  std::iota(a.begin(),a.end(),0.0);
+  save_array(path("a.arr"), cdesc<double,2>(a.data(),3,10));
+
+  chunked_reader<double,2> r(path("a.arr"), 4, {.buffers = 3});
+  EXPECT_EQ(r.size(),3);
+
+  std::size_t expected_first = 0, k = 0;
+  while (auto c = r.next()) {
+    EXPECT_EQ(c->first(),expected_first);
+    EXPECT_EQ(c->extent(0),3);
+    const std::size_t n = c->extent(1);
+    EXPECT_EQ(n, expected_first + 4 <= 10 ? 4 : 2);
+    auto v = c->view();
+    for (std::size_t j = 0; j < n; ++j)
+      for (std::size_t i = 0; i < 3; ++i) EXPECT_EQ(v(i,j), a[k++]);
+    expected_first += n;
+  }
+  EXPECT_EQ(k,a.size());
+  EXPECT_EQ(r.next(),nullptr);
+}
+
+TEST_F(stream_test, readRawToFortran) {
+
+  std::vector<int> a(1000, 2);
+  {
+    std::ofstream f(path("raw.bin"), std::ios::binary);
+    f.write(reinterpret_cast<const char *>(a.data()), a.size()*sizeof(int));
+  }
+
+  chunked_reader<int> r(path("raw.bin"), {1000}, 128);
+  int chunks = 0;
+  while (auto c = r.next()) {
+    EXPECT_EQ(alltwo(*c),1);
+    ++chunks;
+  }
+  EXPECT_EQ(chunks,8);
+}
+
+TEST_F(stream_test, abandonReader) {
+
+  std::vector<float> a(4096);
+  save_array(path("b.arr"), cdesc<float>(a));
+
+  // Destroying the reader midway stops the background thread
+  chunked_reader<float> r(path("b.arr"), 16);
+  EXPECT_NE(r.next(),nullptr);
+  EXPECT_NE(r.next(),nullptr);
+}
+
+TEST_F(stream_test, readErrors) {
+  EXPECT_THROW((chunked_reader<double>(path("missing.arr"), 4)), std::system_error);
+
+  {
+    std::ofstream f(path("short.bin"), std::ios::binary);
+    f << "abcd";
+  }
+  chunked_reader<double> r(path("short.bin"), {100}, 10);
+  EXPECT_THROW(r.next(), std::runtime_error);
+}
+
+TEST_F(stream_test, writeChunks) {
+
+  std::vector<int> a(5*12);
+  std::iota(a.begin(),a.end(),0);
+  cdesc<int,2> fa(a.data(),5,12);
+  {
+    chunked_writer<int,2> w(path("w.arr"), {5,12});
+    // Contiguous slabs, and a section strided in the second dimension
+    w.write(fa.section(full_extent,slice{0,5}));
+    w.write(fa.section(full_extent,slice{5,9}));
+    w.write(fa.section(full_extent,slice{9,12}));
+    EXPECT_EQ(w.written(),12);
+    w.close();
+  }
+
+  auto m = mapped_array<int,2>::open(path("w.arr"));
+  EXPECT_TRUE(std::equal(m.begin(),m.end(),a.begin()));
+}
+
+TEST_F(stream_test, writeStridedSections) {
+
+  std::vector<int> a(6*4);
+  std::iota(a.begin(),a.end(),0);
+  cdesc<int,2> fa(a.data(),6,4);
+
+  // Rows 1,3,5 (unit stride runs of length one are packed) and 
+  // every other column
+  auto rows = fa.section(slice{0,6,2},full_extent);
+  auto cols = fa.section(full_extent,slice{0,4,2});
+  {
+    chunked_writer<int,2> w(path("r.arr"), {3,4});
+    w.write(rows);
+    w.close();
+    chunked_writer<int,2> w2(path("c.arr"), {6,2}, 1);
+    w2.write(cols);
+  }
+
+  auto mr = mapped_array<int,2>::open(path("r.arr"));
+  auto mc = mapped_array<int,2>::open(path("c.arr"));
+  for (int j = 0; j < 4; ++j)
+    for (int i = 0; i < 3; ++i) EXPECT_EQ(mr.view()(i,j), rows(i,j));
+  for (int j = 0; j < 2; ++j)
+    for (int i = 0; i < 6; ++i) EXPECT_EQ(mc.view()(i,j), cols(i,j));
+}
+
+TEST_F(stream_test, pipeline) {
+
+  // Read, transform and write back chunk by chunk
+  std::vector<double> a(7*100);
+  std::iota(a.begin(),a.end(),0.0);
+  save_array(path("in.arr"), cdesc<double,2>(a.data(),7,100));
+
+  std::vector<double> out(7*16);
+  {
+    chunked_reader<double,2> r(path("in.arr"), 16);
+    chunked_writer<double,2> w(path("out.arr"), {7,100}, 1);
+    while (auto c = r.next()) {
+      w.flush(); // out is reused for every chunk
+      const std::size_t n = c->extent(1);
+      for (std::size_t k = 0; k < 7*n; ++k) out[k] = 2*c->data()[k];
+      w.write(cdesc<double,2>(out.data(),7,static_cast<int>(n)));
+    }
+  }
+
+  auto m = mapped_array<double,2>::open(path("out.arr"));
+  for (std::size_t k = 0; k < a.size(); ++k) EXPECT_EQ(m.data()[k], 2*a[k]);
+}
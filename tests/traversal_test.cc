@@ -0,0 +1,114 @@
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Fcpp/traversal.h"
+using namespace Fcpp;
+
+TEST(for_each_row, visitsEveryElementOnce) {
+
+  std::vector<int> a(5*7*3);
+  std::iota(a.begin(),a.end(),0);
+  cdesc<int,3> fa(a.data(),5,7,3);
+
+  std::vector<int> count(a.size(),0);
+  for_each_row(fa, [&](auto row, const auto& idx) {
+    for (std::size_t i = 0; i < row.size(); ++i) {
+      EXPECT_EQ(row[i], fa(idx[0]+i,idx[1],idx[2]));
+      ++count[row[i]];
+    }
+  }, tile_extents{2,3});
+
+  for (int c : count) EXPECT_EQ(c,1);
+}
+
+TEST(for_each_row, unitStrideRowsAreSpans) {
+
+  std::vector<double> a(64*4);
+  cdesc<double,2> fa(a.data(),64,4);
+
+  int rows = 0;
+  for_each_row(fa, [&](auto row, const auto&) {
+    EXPECT_TRUE((std::is_same_v<decltype(row),std::span<double>>));
+    EXPECT_EQ(row.size(), 64);
+    ++rows;
+  });
+  EXPECT_EQ(rows,4);
+}
+
+TEST(for_each_row, tilesFollowColumnMajorOrder) {
+
+  std::vector<int> a(4*4);
+  cdesc<int,2> fa(a.data(),4,4);
+
+  std::vector<std::array<std::ptrdiff_t,2>> starts;
+  for_each_row(fa, [&](auto row, const auto& idx) {
+    EXPECT_EQ(row.size(),2);
+    starts.push_back(idx);
+  }, tile_extents{2,2});
+
+  std::vector<std::array<std::ptrdiff_t,2>> expected = {
+    {0,0},{0,1},{2,0},{2,1},{0,2},{0,3},{2,2},{2,3}};
+  EXPECT_EQ(starts,expected);
+}
+
+TEST(for_each_row, stridedSection) {
+
+  std::vector<int> a(6*4);
+  std::iota(a.begin(),a.end(),0);
+  cdesc<int,2> fa(a.data(),6,4);
+
+  // a(6:1:-2,:)
+  auto s = fa.section(slice{5,-1,-2},full_extent);
+
+  int sum = 0, expected = 0;
+  for (int j = 0; j < 4; ++j)
+    for (int i = 5; i >= 0; i -= 2) expected += fa(i,j);
+
+  for_each_row(s, [&](auto row, const auto& idx) {
+    if constexpr (std::is_same_v<decltype(row),strided_span<int>>) {
+      EXPECT_EQ(row.stride(),-2);
+    } else {
+      ADD_FAILURE() << "expected a strided row";
+    }
+    EXPECT_EQ(row[0], s(idx[0],idx[1]));
+    for (int x : row) sum += x;
+  });
+  EXPECT_EQ(sum,expected);
+}
+
+TEST(for_each_row, transposedInnerDimension) {
+
+  // Row-major storage seen through a descriptor with swapped strides
+  std::vector<int> a(3*5);
+  std::iota(a.begin(),a.end(),0);
+
+  CFI_CDESC_T(2) t;
+  CFI_index_t ext[2] = {3,5};
+  CFI_establish((CFI_cdesc_t *) &t, a.data(), CFI_attribute_other, 
+    CFI_type_int, sizeof(int), 2, ext);
+  t.dim[0].sm = 5*sizeof(int);
+  t.dim[1].sm = sizeof(int);
+
+  cdesc_ptr<int,2> p((CFI_cdesc_t *) &t);
+
+  int next = 0;
+  for_each_row(p, [&](auto row, const auto& idx) {
+    EXPECT_TRUE((std::is_same_v<decltype(row),std::span<int>>));
+    EXPECT_EQ(idx[1],0);
+    for (int x : row) EXPECT_EQ(x,next++);
+  });
+  EXPECT_EQ(next,15);
+}
+
+TEST(for_each_row, emptyArray) {
+
+  std::vector<int> a(4);
+  cdesc<int,2> fa(a.data(),4,1);
+  auto sec = fa.section(full_extent,slice{0,0});
+  cdesc_ptr<int,2> p(sec);
+  int calls = 0;
+  for_each_row(p, [&](auto, const auto&) { ++calls; });
+  EXPECT_EQ(calls,0);
+}
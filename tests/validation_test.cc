@@ -0,0 +1,110 @@
+// Compiled once per validation policy, see CMakeLists.txt
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Fcpp.h"
+using namespace Fcpp;
+
+#if FCPP_VALIDATION == FCPP_VALIDATION_THROW
+
+TEST(validation_throw, descriptorMismatch) {
+
+  std::vector<float> a(4);
+  cdesc<float> fa(a);
+
+  EXPECT_THROW((cdesc_ptr<double,1>(fa.get())), validation_error);
+  EXPECT_THROW((cdesc_ptr<float,2>(fa.get())), validation_error);
+  EXPECT_THROW((cdesc_ptr<float,1,attr::allocatable>(fa.get())), validation_error);
+  EXPECT_NO_THROW((cdesc_ptr<float,1>(fa.get())));
+}
+
+TEST(validation_throw, boundsChecks) {
+
+  std::vector<int> a(6);
+  cdesc<int,2> fa(a.data(),3,2);
+  cdesc_ptr<int,2> p(fa.get());
+
+  EXPECT_NO_THROW(fa(2,1));
+  EXPECT_THROW(fa(3,0), validation_error);
+  EXPECT_THROW(p(0,2), validation_error);
+  EXPECT_THROW(p(-1,0), validation_error);
+  EXPECT_THROW(fa.extent(2), validation_error);
+  EXPECT_THROW(fa.section(full_extent,slice{1,3}), validation_error);
+
+  auto v = fa.section(slice{0,3,2},1);
+  EXPECT_NO_THROW(v[1]);
+  EXPECT_THROW(v[2], validation_error);
+}
+
+#if FCPP_HAS_MDSPAN
+TEST(validation_throw, reversedToMdspan) {
+
+  // a(1:2,3:1:-1) of a 2 x 3 array
+  std::vector<int> a = {0,1,2,3,4,5};
+  using ext_t = std::dextents<CFI_index_t,2>;
+  layout_fortran_strided::mapping<ext_t> map(ext_t(2,3),std::array<CFI_index_t,2>{1,-2});
+  cdesc<int,2> fa(std::mdspan<int,ext_t,layout_fortran_strided>(a.data(),map));
+  EXPECT_EQ(fa(1,2),1);
+
+  // std::layout_stride cannot represent the reversed dimension
+  EXPECT_THROW(fa.to_mdspan(), validation_error);
+  EXPECT_EQ((cdesc_ptr<int,2>(fa.get()).to_mdspan()[0,0]),4);
+}
+#endif
+
+TEST(validation_throw, nonContiguousData) {
+
+  std::vector<int> a(6);
+  cdesc<int> fa(a);
+  auto v = fa.section(slice{0,6,2});
+  cdesc_ptr<int,1> p(v.get());
+
+  EXPECT_THROW(p.data(), validation_error);
+  EXPECT_THROW((cdesc_ptr<int,1,attr::other,layout::contiguous>(v.get())), validation_error);
+}
+
+#elif FCPP_VALIDATION == FCPP_VALIDATION_CALLBACK
+
+static int failures = 0;
+
+static void count_failure(const char *, const char *, int) { ++failures; }
+
+TEST(validation_callback, handlerIsCalled) {
+
+  validation_handler prev = set_validation_handler(count_failure);
+
+  std::vector<int> a(4);
+  cdesc<int> fa(a);
+  cdesc_ptr<int,1,attr::pointer> p(fa.get());
+  EXPECT_EQ(failures,1);
+
+  (void) fa[4];
+  EXPECT_EQ(failures,2);
+
+  // The strides are read only from the dimensions of the descriptor
+  cdesc_ptr<int,3> q(fa.get());
+  EXPECT_EQ(failures,3);
+
+  EXPECT_EQ(set_validation_handler(prev),count_failure);
+}
+
+#elif FCPP_VALIDATION == FCPP_VALIDATION_UNCHECKED
+
+static_assert(FCPP_BOUNDS_CHECK == 0);
+
+TEST(validation_unchecked, noChecks) {
+
+  std::vector<float> a(4);
+  cdesc<float> fa(a);
+
+  // The conditions are not evaluated
+  int evaluated = 0;
+  FCPP_CHECK(++evaluated > 0);
+  EXPECT_EQ(evaluated,0);
+
+  cdesc_ptr<float,1> p(fa.get());
+  EXPECT_EQ(&p[3],a.data()+3);
+}
+
+#endif
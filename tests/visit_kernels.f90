@@ -0,0 +1,66 @@
+! Fortran callers of the generic C++ entry points in visit_test.cc
+
+module visit_interfaces
+use, intrinsic :: iso_c_binding, only: c_double, c_int
+implicit none
+interface
+  ! double sum_any(CFI_cdesc_t *a);
+  real(c_double) function sum_any(a) bind(c)
+    import :: c_double
+    type(*), dimension(..), intent(in) :: a
+  end function
+  ! void scale_any(CFI_cdesc_t *a, int factor);
+  subroutine scale_any(a,factor) bind(c)
+    import :: c_int
+    type(*), dimension(..), intent(inout) :: a
+    integer(c_int), value :: factor
+  end subroutine
+end interface
+end module
+
+! void visit_sums(double sums[5]);
+subroutine visit_sums(sums) bind(c)
+use, intrinsic :: iso_c_binding, only: c_double, c_float, c_int
+use visit_interfaces
+implicit none
+real(c_double), intent(out) :: sums(5)
+real(c_double) :: a(10), s
+real(c_float) :: b(4,6)
+integer(c_int) :: c(2,3,4)
+integer :: i
+a = [(real(i,c_double), i = 1, 10)]
+b = 0.5_c_float
+c = 2_c_int
+sums(1) = sum_any(a)
+sums(2) = sum_any(a(1::2))
+sums(3) = sum_any(b(2:3,:))
+sums(4) = sum_any(c)
+s = 7.0_c_double
+sums(5) = sum_any(s)
+end subroutine
+
+! void visit_scale(int c[24]);
+subroutine visit_scale(c) bind(c)
+use, intrinsic :: iso_c_binding, only: c_int
+use visit_interfaces
+implicit none
+integer(c_int), intent(inout) :: c(2,3,4)
+call scale_any(c(:,2,:),3_c_int)
+end subroutine
+
+! double visit_assumed_size(double *a, int n);
+real(c_double) function visit_assumed_size(a,n) bind(c)
+use, intrinsic :: iso_c_binding, only: c_double, c_int
+use visit_interfaces
+implicit none
+integer(c_int), value :: n
+real(c_double), intent(in) :: a(n,*)
+interface
+  real(c_double) function sum_assumed_size(a,ncols) bind(c)
+    import :: c_double, c_int
+    real(c_double), dimension(..), intent(in) :: a
+    integer(c_int), value :: ncols
+  end function
+end interface
+visit_assumed_size = sum_assumed_size(a,3_c_int)
+end function
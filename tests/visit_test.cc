@@ -0,0 +1,109 @@
+#include <complex>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Fcpp/visit.h"
+using namespace Fcpp;
+
+// Sum of any array, accumulated in the element order of Fortran
+template<typename Array>
+double sum_of(const Array& a) {
+  constexpr int rank = Fcpp_impl_::array_rank<Array>::value;
+  if constexpr (rank == 0) {
+    return static_cast<double>(*static_cast<const typename Array::value_type *>(a.get()->base_addr));
+  } else if constexpr (rank == 1) {
+    double s = 0;
+    for (auto x : a) s += static_cast<double>(x);
+    return s;
+  } else {
+    double s = 0;
+    const CFI_cdesc_t *d = a.get();
+    CFI_index_t n = 1;
+    for (int r = 0; r < rank; ++r) n *= d->dim[r].extent;
+    for (CFI_index_t i = 0; i < n; ++i) {
+      CFI_index_t subs[rank], rem = i;
+      for (int r = 0; r < rank; ++r) {
+        subs[r] = d->dim[r].lower_bound + rem % d->dim[r].extent;
+        rem /= d->dim[r].extent;
+      }
+      s += static_cast<double>(*static_cast<const typename Array::value_type *>(
+        CFI_address(d,subs)));
+    }
+    return s;
+  }
+}
+
+extern "C" double sum_any(CFI_cdesc_t *a) {
+  return visit<type_list<float,double,int>,rank_list<0,1,2,3>>(a, [](auto x) {
+    return sum_of(x);
+  });
+}
+
+extern "C" void scale_any(CFI_cdesc_t *a, int factor) {
+  visit(a, [factor](auto x) {
+    using T = typename decltype(x)::value_type;
+    if constexpr (Fcpp_impl_::array_rank<decltype(x)>::value == 2 && std::is_integral_v<T>) {
+      for (std::size_t j = 0; j < x.extent(1); ++j)
+        for (std::size_t i = 0; i < x.extent(0); ++i) x(i,j) *= static_cast<T>(factor);
+    } else {
+      throw std::invalid_argument("scale_any: rank-2 integers expected");
+    }
+  });
+}
+
+extern "C" double sum_assumed_size(CFI_cdesc_t *a, int ncols) {
+  auto v = cdesc_view<double,2>::assumed_size(a,ncols);
+  return sum_of(v);
+}
+
+extern "C" void visit_sums(double sums[5]);
+extern "C" void visit_scale(int c[24]);
+extern "C" double visit_assumed_size(double *a, int n);
+
+TEST(visit, dispatchesOnRankAndType) {
+
+  double sums[5];
+  visit_sums(sums);
+  EXPECT_EQ(sums[0],55.0);            // a(10)
+  EXPECT_EQ(sums[1],25.0);            // a(1::2)
+  EXPECT_EQ(sums[2],6.0);             // b(2:3,:), real(c_float)
+  EXPECT_EQ(sums[3],48.0);            // c(2,3,4), integer(c_int)
+  EXPECT_EQ(sums[4],7.0);             // scalar
+}
+
+TEST(visit, writesThroughSection) {
+
+  std::vector<int> c(24,1);
+  visit_scale(c.data());
+
+  // c(:,2,:) was scaled
+  for (int k = 0; k < 4; ++k)
+    for (int j = 0; j < 3; ++j)
+      for (int i = 0; i < 2; ++i) EXPECT_EQ(c[i + 2*j + 6*k],j == 1 ? 3 : 1);
+}
+
+TEST(visit, assumedSize) {
+
+  std::vector<double> a(12);
+  std::iota(a.begin(),a.end(),1.0);
+  EXPECT_EQ(visit_assumed_size(a.data(),4),78.0);
+}
+
+TEST(visit, rejectsOtherDescriptors) {
+
+  std::vector<std::complex<double>> z(3);
+  cdesc<std::complex<double>> fz(z);
+  EXPECT_THROW(sum_any(fz),std::invalid_argument);
+
+  std::vector<double> a(2*2*2*2);
+  cdesc<double,4> fa(a.data(),2,2,2,2);
+  EXPECT_THROW(sum_any(fa),std::invalid_argument);
+
+  // An assumed-size descriptor
+  cdesc<double,2> fb(a.data(),4,4);
+  fb.get()->dim[1].extent = -1;
+  EXPECT_THROW(sum_any(fb),std::invalid_argument);
+}